@@ -0,0 +1,381 @@
+#include <vector>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+#include <QTextStream>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "f3dviewer.h"
+#include "f3dwidget/F3DBootstrap.h"
+#include "f3dwidget/F3DFrameStats.h"
+#include "f3dwidget/F3DInputLog.h"
+#include "f3dwidget/F3DModelGen.h"
+#include "f3dwidget/F3DWidget.h"
+
+// Headless load and render benchmark over generated models. Every timing
+// goes through F3DWidget, so it measures what a preview in Seer pays.
+//
+//   f3dviewer_bench --sizes 10000,1000000 --out result.json
+//   f3dviewer_bench --replay input.jsonl [--model file] --out result.json
+//
+// Replay feeds an input recording made with --viewer.record back into the
+// widget at its original pace and reports the frame times it produced.
+//
+// F3DWidget renders through QOpenGLWidget, which needs a platform with GL
+// contexts; Qt's offscreen platform gets those from GLX, so it needs an X
+// server too. Without DISPLAY or WAYLAND_DISPLAY on Linux the bench runs
+// itself again under xvfb-run, and stops when that is not installed. On
+// GPU-less boxes Mesa's llvmpipe provides GL (LIBGL_ALWAYS_SOFTWARE=1).
+
+namespace {
+
+using f3d::modelgen::Kind;
+
+constexpr auto g_default_sizes = "10000,100000,1000000";
+constexpr int g_default_frames = 120;
+constexpr int g_default_seeks  = 20;
+constexpr int g_timeout_ms     = 10 * 60 * 1000;
+constexpr int g_frame_wait_ms  = 5000;
+
+// frames still in flight once the last replayed event was sent
+constexpr int g_replay_settle_ms = 500;
+
+// set in the environment of the run under xvfb-run, so it happens once
+constexpr auto g_env_xvfb = "F3DVIEWER_BENCH_XVFB";
+
+struct Config {
+    QString modelDir;
+    QList<qint64> sizes;
+    QList<Kind> kinds;
+    int frames = g_default_frames;
+    int seeks  = g_default_seeks;
+    QSize viewSize{1280, 720};
+};
+
+bool waitFrame(QSignalSpy &swapped)
+{
+    swapped.clear();
+    return swapped.wait(g_frame_wait_ms);
+}
+
+// Shows `path` and waits for its first frame, timings or the error go to `ret`
+bool openView(F3DWidget &view,
+              QSignalSpy &swapped,
+              const QString &path,
+              QJsonObject &ret)
+{
+    QElapsedTimer et;
+    et.start();
+    QSignalSpy loaded(&view, &F3DWidget::sigLoaded);
+    QSignalSpy failed(&view, &F3DWidget::sigLoadFailed);
+    view.load(path);
+    view.show();
+    if (loaded.isEmpty() && failed.isEmpty()) {
+        QEventLoop loop;
+        QObject::connect(&view, &F3DWidget::sigLoaded, &loop,
+                         &QEventLoop::quit);
+        QObject::connect(&view, &F3DWidget::sigLoadFailed, &loop,
+                         &QEventLoop::quit);
+        QTimer::singleShot(g_timeout_ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    if (!failed.isEmpty()) {
+        ret["error"] = "load failed";
+        return false;
+    }
+    if (loaded.isEmpty()) {
+        ret["error"] = "load timed out";
+        return false;
+    }
+    ret["load_ms"] = et.elapsed();
+    if (!waitFrame(swapped)) {
+        ret["error"] = "no frame after load";
+        return false;
+    }
+    ret["first_frame_ms"] = et.elapsed();
+    return true;
+}
+
+QJsonObject runModel(const f3d::modelgen::Model &model, const Config &cfg)
+{
+    QJsonObject ret{
+        {"name", model.name},
+        {"kind", f3d::modelgen::kindName(model.kind)},
+        {"primitives", model.primitives},
+        {"animated", model.animated},
+        {"file_bytes", QFileInfo(model.path).size()},
+    };
+
+    F3DWidget view;
+    view.resize(cfg.viewSize);
+    QSignalSpy swapped(&view, &QOpenGLWidget::frameSwapped);
+    if (!openView(view, swapped, model.path, ret)) {
+        return ret;
+    }
+    QElapsedTimer et;
+
+    // steady state: back to back redraws of an unchanged scene
+    view.applyOptions({"--viewer.render.continuous=1"});
+    view.resetFrameStats();
+    et.restart();
+    while (view.frameStats().frames < cfg.frames && et.elapsed() < g_timeout_ms
+           && swapped.wait(g_frame_wait_ms)) {
+    }
+    view.applyOptions({"--viewer.render.continuous=0"});
+    ret["frame"] = f3d::framestats::toJsonObject(view.frameStats());
+
+    // seek to evenly spaced times and wait for each presented frame
+    if (view.hasAnimation()) {
+        view.setAnimationState(false);
+        f3d::framestats::Recorder seeks;
+        const double duration = view.getAnimationDuration();
+        for (int i = 0; i < cfg.seeks; ++i) {
+            et.restart();
+            view.seekAnimation(duration * i / qMax(1, cfg.seeks - 1));
+            if (!waitFrame(swapped)) {
+                break;
+            }
+            seeks.record(et.nsecsElapsed() / 1e6, -1);
+        }
+        ret["seek_ms"] = f3d::framestats::toJsonObject(seeks.summary().cpu);
+    }
+
+    // option write to presented frame, averaged over on and off, for each
+    // option the sidebar toggles
+    QJsonObject toggles;
+    for (const QString &key : F3DViewer::viewOptionKeys()) {
+        const bool on = view.getOption(key).toBool();
+        double total  = 0;
+        int count     = 0;
+        for (const bool value : {!on, on}) {
+            et.restart();
+            view.setOption(key, value ? "1" : "0");
+            if (waitFrame(swapped)) {
+                total += et.nsecsElapsed() / 1e6;
+                ++count;
+            }
+        }
+        if (count > 0) {
+            toggles[key] = total / count;
+        }
+    }
+    ret["toggle_ms"] = toggles;
+    return ret;
+}
+
+QJsonObject runReplay(const f3d::input::Recording &recording,
+                      const QString &model)
+{
+    QJsonObject ret{
+        {"model", model},
+        {"events", int(recording.events.size())},
+    };
+
+    F3DWidget view;
+    view.resize(recording.size);
+    QSignalSpy swapped(&view, &QOpenGLWidget::frameSwapped);
+    if (!openView(view, swapped, model, ret)) {
+        return ret;
+    }
+
+    view.resetFrameStats();
+    QElapsedTimer clock;
+    clock.start();
+    for (const auto &event : recording.events) {
+        const qint64 wait = event.time - clock.elapsed();
+        if (wait > 0) {
+            QTest::qWait(int(wait));
+        }
+        if (event.type == QEvent::Resize) {
+            view.resize(event.size);
+        }
+        else if (auto e = f3d::input::toQEvent(event)) {
+            QCoreApplication::sendEvent(&view, e.get());
+        }
+    }
+    QTest::qWait(g_replay_settle_ms);
+    ret["duration_ms"] = clock.elapsed();
+    ret["frame"]       = f3d::framestats::toJsonObject(view.frameStats());
+    return ret;
+}
+
+QList<qint64> parseSizes(const QString &text)
+{
+    QList<qint64> ret;
+    for (const auto &part : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok          = false;
+        const qint64 val = part.trimmed().toLongLong(&ok);
+        if (ok && val > 0) {
+            ret << val;
+        }
+    }
+    return ret;
+}
+
+QList<Kind> parseKinds(const QString &text)
+{
+    const QList<Kind> all = {Kind::StlBinary, Kind::PlyPoints, Kind::Obj,
+                             Kind::Gltf, Kind::GltfAnimated};
+    if (text.isEmpty()) {
+        return all;
+    }
+    QList<Kind> ret;
+    for (const auto &name : text.split(',', Qt::SkipEmptyParts)) {
+        for (const auto kind : all) {
+            if (f3d::modelgen::kindName(kind) == name.trimmed()) {
+                ret << kind;
+            }
+        }
+    }
+    return ret;
+}
+
+#ifdef Q_OS_LINUX
+// Runs the bench again under its own X server, returns only on failure
+int execUnderXvfb(char *argv[])
+{
+    if (qEnvironmentVariableIsSet(g_env_xvfb)) {
+        QTextStream(stderr) << "no display under xvfb-run" << Qt::endl;
+        return 1;
+    }
+    qputenv(g_env_xvfb, "1");
+    std::vector<char *> args{const_cast<char *>("xvfb-run"),
+                             const_cast<char *>("-a")};
+    for (int i = 0; argv[i]; ++i) {
+        args.push_back(argv[i]);
+    }
+    args.push_back(nullptr);
+    execvp(args[0], args.data());
+    QTextStream(stderr) << "no display and xvfb-run not found, install xvfb "
+                           "or set DISPLAY"
+                        << Qt::endl;
+    return 1;
+}
+#endif
+
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef Q_OS_LINUX
+    if (!qEnvironmentVariableIsSet("DISPLAY")
+        && !qEnvironmentVariableIsSet("WAYLAND_DISPLAY")) {
+        return execUnderXvfb(argv);
+    }
+#endif
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("f3dviewer_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Times load, first frame, steady frames, animation seeks and option "
+        "toggles of F3DWidget on generated models.");
+    parser.addHelpOption();
+    const QCommandLineOption outOpt({"o", "out"},
+                                    "Write the JSON report to <file>.", "file");
+    const QCommandLineOption dirOpt(
+        "models", "Directory for generated models, reused across runs.", "dir",
+        QDir(QDir::tempPath()).filePath("f3dviewer_bench"));
+    const QCommandLineOption sizesOpt(
+        "sizes", "Comma separated triangle or point counts.", "list",
+        g_default_sizes);
+    const QCommandLineOption kindsOpt(
+        "kinds", "Comma separated subset of stl, ply-points, obj, gltf, "
+                 "gltf-animated.",
+        "list");
+    const QCommandLineOption framesOpt(
+        "frames", "Steady state frames to measure.", "n",
+        QString::number(g_default_frames));
+    const QCommandLineOption seeksOpt("seeks", "Animation seeks to measure.",
+                                      "n", QString::number(g_default_seeks));
+    const QCommandLineOption replayOpt(
+        "replay", "Replay an input recording instead of generated models.",
+        "file");
+    const QCommandLineOption modelOpt(
+        "model", "Model for --replay, defaults to the recorded one.", "file");
+    parser.addOptions({outOpt, dirOpt, sizesOpt, kindsOpt, framesOpt, seeksOpt,
+                       replayOpt, modelOpt});
+    parser.process(app);
+
+    Config cfg;
+    cfg.modelDir = parser.value(dirOpt);
+    cfg.sizes    = parseSizes(parser.value(sizesOpt));
+    cfg.kinds    = parseKinds(parser.value(kindsOpt));
+    cfg.frames   = qMax(1, parser.value(framesOpt).toInt());
+    cfg.seeks    = qMax(1, parser.value(seeksOpt).toInt());
+
+    QTextStream err(stderr);
+    QJsonArray models;
+    QJsonObject replay;
+    if (parser.isSet(replayOpt)) {
+        const auto recording = f3d::input::load(parser.value(replayOpt));
+        if (!recording) {
+            err << "could not read " << parser.value(replayOpt) << Qt::endl;
+            return 1;
+        }
+        const QString model = parser.isSet(modelOpt) ? parser.value(modelOpt)
+                                                     : recording->model;
+        replay           = runReplay(*recording, model);
+        replay["replay"] = parser.value(replayOpt);
+        cfg.sizes.clear();
+    }
+    for (const qint64 size : cfg.sizes) {
+        for (const auto kind : cfg.kinds) {
+            QElapsedTimer et;
+            et.start();
+            const auto model
+                = f3d::modelgen::generate(cfg.modelDir, kind, size);
+            if (model.path.isEmpty()) {
+                err << "could not generate " << model.name << Qt::endl;
+                continue;
+            }
+            const qint64 generateMs = et.elapsed();
+            err << "running " << model.name << Qt::endl;
+            auto result           = runModel(model, cfg);
+            result["generate_ms"] = generateMs;
+            models.append(result);
+        }
+    }
+
+    QJsonObject report{
+        {"date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"f3d", f3d::bootstrap::libVersion()},
+        {"qt", qVersion()},
+        {"platform", QGuiApplication::platformName()},
+        {"view", QString("%1x%2")
+                     .arg(cfg.viewSize.width())
+                     .arg(cfg.viewSize.height())},
+    };
+    if (replay.isEmpty()) {
+        report["models"] = models;
+    }
+    else {
+        report["replay"] = replay;
+    }
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (!parser.isSet(outOpt)) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile out(parser.value(outOpt));
+    if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+        err << "could not write " << out.fileName() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
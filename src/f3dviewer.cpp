@@ -1,55 +1,132 @@
 #include "f3dviewer.h"
 
+#include <optional>
+
 #include <QApplication>
+#include <QClipboard>
+#include <QDateTime>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QKeyEvent>
 #include <QPainter>
 #include <QSettings>
+#include <QtConcurrent>
 #include <QShortcut>
 #include <QStandardPaths>
 #include <QSvgRenderer>
 #include <QTimer>
 #include <QToolButton>
 
+#include "f3dwidget/F3DBootstrap.h"
+#include "f3dwidget/F3DFrameCache.h"
+#include "f3dwidget/F3DMetrics.h"
+#include "f3dwidget/F3DPrefetch.h"
+#include "f3dwidget/F3DTrace.h"
 #include "f3dwidget/F3DWidget.h"
 #include "seer/viewerhelper.h"
 #include "sidebarwnd.h"
 
 #define qprintt qDebug() << "[F3DViewer]"
 
+// Boolean view option shared by the sidebar, the INI, key bindings and reset
+struct F3DViewOption {
+    const char *option;
+    // INI key, nullptr keeps the option per preview
+    const char *ini;
+    bool def;
+    bool SidebarWnd::State::*field;
+    void (SidebarWnd::*signal)(bool);
+    // unmodified key toggling it in F3DWidget::handleKey, 0 for none
+    int key;
+};
+
 namespace {
 constexpr auto g_ini_sidebar_visible = "sidebar_visible";
-constexpr auto g_ini_grid            = "display_grid";
-constexpr auto g_ini_axis            = "display_axis";
-constexpr auto g_ini_edge            = "display_edge";
-constexpr auto g_ini_point_sprites   = "display_point_sprites";
-constexpr auto g_ini_scalar_bar      = "display_scalar_bar";
-constexpr auto g_ini_metadata        = "display_metadata";
-constexpr auto g_ini_fps             = "display_fps";
-
-struct ViewDefaults {
-    bool axis             = true;
-    bool grid             = true;
-    bool edge             = false;
-    bool pointSprites     = false;
-    bool scalarBar        = false;
-    bool metadata         = false;
-    bool fps              = false;
-    bool antiAliasing     = false;
-    bool ambientOcclusion = false;
-    bool toneMapping      = false;
-    bool translucency     = false;
-    double opacity        = 1.0;
-    bool hdriAmbient      = false;
-    bool skybox           = false;
-    bool volume           = false;
-    bool backgroundBlur   = false;
-    bool orthographic     = false;
+// INI changes are written once this long after the last one
+constexpr int g_ini_flush_ms = 1000;
+
+using State   = SidebarWnd::State;
+using Sidebar = SidebarWnd;
+
+// INI keys come first, their order is part of the frame cache key
+constexpr F3DViewOption g_view_options[] = {
+    {"render.grid.enable", "display_grid", true, &State::grid,
+     &Sidebar::sigShowGrid, Qt::Key_G},
+    {"ui.axis", "display_axis", true, &State::axis, &Sidebar::sigShowAxis, 0},
+    {"render.show_edges", "display_edge", false, &State::edge,
+     &Sidebar::sigShowEdge, Qt::Key_E},
+    {"model.point_sprites.enable", "display_point_sprites", false,
+     &State::pointSprites, &Sidebar::sigShowPointSprites, Qt::Key_O},
+    {"ui.scalar_bar", "display_scalar_bar", false, &State::scalarBar,
+     &Sidebar::sigShowScalarBar, Qt::Key_B},
+    {"ui.metadata", "display_metadata", false, &State::metadata,
+     &Sidebar::sigShowMetadata, Qt::Key_M},
+    {"ui.fps", "display_fps", false, &State::fps, &Sidebar::sigShowFPS,
+     Qt::Key_Z},
+    {"render.effect.anti_aliasing", nullptr, false, &State::antiAliasing,
+     &Sidebar::sigShowAntiAliasing, Qt::Key_A},
+    {"render.effect.ambient_occlusion", nullptr, false,
+     &State::ambientOcclusion, &Sidebar::sigShowAmbientOcclusion, Qt::Key_Q},
+    {"render.effect.tone_mapping", nullptr, false, &State::toneMapping,
+     &Sidebar::sigShowToneMapping, Qt::Key_T},
+    {"render.effect.translucency_support", nullptr, false,
+     &State::translucencySupport, &Sidebar::sigShowTranslucencySupport,
+     Qt::Key_P},
+    {"render.hdri.ambient", nullptr, false, &State::hdriAmbient,
+     &Sidebar::sigShowHdriAmbient, Qt::Key_F},
+    {"render.background.skybox", nullptr, false, &State::skybox,
+     &Sidebar::sigShowSkybox, Qt::Key_J},
+    {"model.volume.enable", nullptr, false, &State::volumeRendering,
+     &Sidebar::sigShowVolumeRendering, Qt::Key_V},
+    {"render.background.blur.enable", nullptr, false, &State::backgroundBlur,
+     &Sidebar::sigShowBackgroundBlur, Qt::Key_U},
+    {"scene.camera.orthographic", nullptr, false, &State::orthographic,
+     &Sidebar::sigOrthographicChanged, 0},
 };
+constexpr double g_default_opacity = 1.0;
+
+constexpr auto g_arg_prefetch_budget     = "viewer.prefetch.budget_mb";
+constexpr qint64 g_prefetch_budget_mb    = 256;
+constexpr auto g_arg_frame_cache_budget  = "viewer.frame_cache.budget_mb";
+constexpr qint64 g_frame_cache_budget_mb = 64;
+// sidebar Performance panel refresh
+constexpr int g_perf_refresh_ms = 500;
+// animation progress updates per second while the sidebar is shown
+constexpr auto g_arg_progress_rate = "viewer.sidebar.progress_hz";
+constexpr int g_progress_rate      = 15;
+// output files of the load trace and of the input recording, "1" picks one
+// in the cache directory
+constexpr auto g_arg_trace  = "viewer.trace";
+constexpr auto g_env_trace  = "F3DVIEWER_TRACE";
+constexpr auto g_arg_record = "viewer.record";
+constexpr auto g_env_record = "F3DVIEWER_RECORD";
+// previews kept in the rolling metrics file next to the INI
+constexpr int g_metrics_max_entries = 1000;
+// resident set size polling while the worker parses
+constexpr int g_rss_sample_ms = 100;
+
+// Table entry a key press toggles, modified keys do something else
+const F3DViewOption *viewOptionForKey(int key, Qt::KeyboardModifiers mods)
+{
+    if (mods & (Qt::ShiftModifier | Qt::ControlModifier)) {
+        return nullptr;
+    }
+    for (const auto &opt : g_view_options) {
+        if (opt.key != 0 && opt.key == key) {
+            return &opt;
+        }
+    }
+    return nullptr;
+}
 
-ViewDefaults defaultViewOptions()
+int opacityPercent(double opacity)
 {
-    return {};
+    return qRound(opacity * 100.0);
 }
 
 double optionDoubleOr(const QVariant &value, double fallback)
@@ -62,6 +139,22 @@ double optionDoubleOr(const QVariant &value, double fallback)
     return ok ? result : fallback;
 }
 
+const QStringList &supportedFormats()
+{
+    static const QStringList formats = []() {
+        QFile f(":/f3dviewer/plugin.json");
+        if (!f.open(QIODevice::ReadOnly)) {
+            return QStringList();
+        }
+        return QJsonDocument::fromJson(f.readAll())
+            .object()
+            .value("formats")
+            .toVariant()
+            .toStringList();
+    }();
+    return formats;
+}
+
 constexpr auto g_svg_sidebar = R"SVG(
 <svg xmlns="http://www.w3.org/2000/svg" viewBox="0 0 24 24" fill="none"
      stroke="currentColor" stroke-width="2" stroke-linecap="round" stroke-linejoin="round">
@@ -93,19 +186,36 @@ QIcon svgIcon(const char *svg_data, bool dark_theme, qreal dpr)
 }
 }  // namespace
 
+QStringList F3DViewer::viewOptionKeys()
+{
+    QStringList ret;
+    for (const auto &opt : g_view_options) {
+        ret << opt.option;
+    }
+    return ret;
+}
+
 F3DViewer::F3DViewer(QWidget *parent) : ViewerBase(parent)
 {
     qprintt << this;
     m_ini           = new QSettings(getIniPath(), QSettings::IniFormat, this);
     m_options_ready = false;
+    m_ini_flush     = new QTimer(this);
+    m_ini_flush->setSingleShot(true);
+    m_ini_flush->setInterval(g_ini_flush_ms);
+    connect(m_ini_flush, &QTimer::timeout, this, &F3DViewer::flushIni);
+    m_rss_sampler = new QTimer(this);
+    m_rss_sampler->setInterval(g_rss_sample_ms);
+    connect(m_rss_sampler, &QTimer::timeout, this, &F3DViewer::sampleRss);
     if (m_ini) {
-        m_sidebar_visible_pref
-            = m_ini->value(g_ini_sidebar_visible, true).toBool();
+        m_sidebar_visible_pref = iniValue(g_ini_sidebar_visible, true).toBool();
     }
 }
 
 F3DViewer::~F3DViewer()
 {
+    // closed before the first frame, keep what was recorded
+    f3d::trace::finish(m_trace_session);
     saveIni();
     qprintt << "~" << this;
 }
@@ -115,30 +225,30 @@ void F3DViewer::saveIni()
     if (!m_ini) {
         return;
     }
-    m_ini->setValue(g_ini_sidebar_visible, m_sidebar_visible_pref);
+    setIniValue(g_ini_sidebar_visible, m_sidebar_visible_pref);
     if (m_view) {
         saveDisplayIni();
     }
-    m_ini->sync();
+    flushIni();
 }
 
 void F3DViewer::saveDisplayIni()
 {
-    if (!m_ini || !m_view) {
+    // before the INI values were applied the state is not the user's
+    if (!m_ini || !m_view || !m_options_ready) {
         return;
     }
 
-    m_ini->setValue(g_ini_grid,
-                    m_view->getOption("render.grid.enable").toBool());
-    m_ini->setValue(g_ini_axis, m_view->getOption("ui.axis").toBool());
-    m_ini->setValue(g_ini_edge,
-                    m_view->getOption("render.show_edges").toBool());
-    m_ini->setValue(g_ini_point_sprites,
-                    m_view->getOption("model.point_sprites.enable").toBool());
-    m_ini->setValue(g_ini_scalar_bar,
-                    m_view->getOption("ui.scalar_bar").toBool());
-    m_ini->setValue(g_ini_metadata, m_view->getOption("ui.metadata").toBool());
-    m_ini->setValue(g_ini_fps, m_view->getOption("ui.fps").toBool());
+    // m_state only lags the view if a toggle was missed, read it back
+    const bool live = !m_view->isLoading();
+    for (const auto &opt : g_view_options) {
+        if (opt.ini) {
+            if (live) {
+                m_state.*opt.field = m_view->getOption(opt.option).toBool();
+            }
+            setIniValue(opt.ini, m_state.*opt.field);
+        }
+    }
 }
 
 QSize F3DViewer::getContentSize() const
@@ -191,15 +301,28 @@ void F3DViewer::keyPressEvent(QKeyEvent *event)
         setSidebarVisible(!m_sidebar->isVisible());
         return;
     }
+    // the view reports back through sigKeyHandled
     if (m_view) {
         qApp->sendEvent(m_view, event);
-        syncSidebar();
     }
 }
 
 void F3DViewer::loadImpl(QBoxLayout *lay_content, QHBoxLayout *lay_ctrlbar)
 {
+    if (const QString trace
+        = debugOutputFile(g_arg_trace, g_env_trace, "trace", "json");
+        !trace.isEmpty()) {
+        m_trace_session = f3d::trace::start(trace);
+    }
+    f3d::trace::Scope trace("loadImpl");
+    m_load_clock.start();
+    m_rss_before = f3d::metrics::currentRss();
+    m_rss_peak   = m_rss_before;
+    m_rss_sampler->start();
     m_view = new F3DWidget(this);
+    const QString cacheDir = getCacheDir({});
+    QDir().mkpath(cacheDir);
+    m_view->setReaderCache(QDir(cacheDir).filePath("readers.ini"));
     initSidebar();
     QHBoxLayout *hbl = new QHBoxLayout();
     hbl->setContentsMargins(0, 0, 0, 0);
@@ -208,6 +331,15 @@ void F3DViewer::loadImpl(QBoxLayout *lay_content, QHBoxLayout *lay_ctrlbar)
     hbl->addWidget(m_sidebar);
 
     lay_content->addLayout(hbl);
+    if (pluginArgMB(g_arg_frame_cache_budget, g_frame_cache_budget_mb) > 0) {
+        f3d::trace::Scope trace("frameCache.load");
+        m_frame_key
+            = f3d::framecache::key(options()->path(), frameCacheOptions());
+        const QImage frame
+            = f3d::framecache::load(getCacheDir("frames"), m_frame_key);
+        m_frame_cache_hit = !frame.isNull();
+        m_view->setPlaceholder(frame);
+    }
     if (!m_view->load(options()->path())) {
         emit sigCommand(VCT_StateChange, VCV_Error);
         return;
@@ -245,7 +377,10 @@ void F3DViewer::initSidebar()
             [this]() { setSidebarVisible(!m_sidebar->isVisible()); });
 
     // Apply INI display settings after engine+model are ready
+    connect(m_view, &F3DWidget::sigLoadFailed, this,
+            [this]() { reportLoadMetrics(false); });
     connect(m_view, &F3DWidget::sigLoaded, this, [this]() {
+        m_load_ms = m_load_clock.elapsed();
         if (!m_ini) {
             syncSidebar();
             QTimer::singleShot(0, this, [this]() {
@@ -253,17 +388,13 @@ void F3DViewer::initSidebar()
             });
             return;
         }
-        auto applyBool = [this](const char *iniKey, const char *opt, bool def) {
-            bool v = m_ini->value(iniKey, def).toBool();
-            m_view->setOption(opt, v ? "1" : "0");
-        };
-        applyBool(g_ini_grid, "render.grid.enable", true);
-        applyBool(g_ini_axis, "ui.axis", true);
-        applyBool(g_ini_edge, "render.show_edges", false);
-        applyBool(g_ini_point_sprites, "model.point_sprites.enable", false);
-        applyBool(g_ini_scalar_bar, "ui.scalar_bar", false);
-        applyBool(g_ini_metadata, "ui.metadata", false);
-        applyBool(g_ini_fps, "ui.fps", false);
+        std::optional<f3d::trace::Scope> trace(std::in_place, "applyOptions");
+        for (const auto &opt : g_view_options) {
+            if (opt.ini) {
+                const bool on = iniValue(opt.ini, opt.def).toBool();
+                m_view->setOption(opt.option, on ? "1" : "0");
+            }
+        }
         // plugin.json args override INI
         auto cmd = options()
                        ->property(ViewOptionsKeys::kKeyPluginCmd)
@@ -274,14 +405,63 @@ void F3DViewer::initSidebar()
         m_options_ready = true;
         updateTheme(options()->theme());
         syncSidebar();
+        trace.reset();
+        if (const QString record = debugOutputFile(g_arg_record, g_env_record,
+                                                   "input", "jsonl");
+            !record.isEmpty()) {
+            m_view->startInputRecording(record);
+        }
         QTimer::singleShot(
             0, this, [this]() { setSidebarVisible(m_sidebar_visible_pref); });
+
+        prefetchNeighbours();
+
+        // first frame with INI and plugin.json options applied
+        connect(m_view, &QOpenGLWidget::frameSwapped, this,
+                &F3DViewer::storeFirstFrame, Qt::SingleShotConnection);
+        connect(
+            m_view, &QOpenGLWidget::frameSwapped, this,
+            [this]() {
+                f3d::trace::mark("first frame");
+                f3d::trace::finish(m_trace_session);
+                m_trace_session = 0;
+                reportLoadMetrics(true);
+            },
+            Qt::SingleShotConnection);
     });
     connect(m_view, &F3DWidget::sigAnimationStateChanged, this,
             [this](bool) { syncSidebar(); });
-    connect(m_view, &F3DWidget::sigAnimationProgressChanged, m_sidebar,
+    // keys typed into the focused view never pass through keyPressEvent
+    connect(m_view, &F3DWidget::sigKeyHandled, this,
+            [this](int key, Qt::KeyboardModifiers mods) {
+                if (const auto *opt = viewOptionForKey(key, mods)) {
+                    syncViewOption(*opt);
+                }
+                else {
+                    syncSidebar();
+                }
+            });
+    bool ok          = false;
+    const int rate   = pluginArg(g_arg_progress_rate).toInt(&ok);
+    m_progress.timer = new QTimer(this);
+    m_progress.timer->setSingleShot(true);
+    m_progress.timer->setInterval(
+        1000 / qBound(1, ok ? rate : g_progress_rate, 1000));
+    connect(m_progress.timer, &QTimer::timeout, this, [this]() {
+        if (m_progress.pending && m_sidebar->isVisible()) {
+            flushProgress();
+        }
+    });
+    connect(m_view, &F3DWidget::sigAnimationProgressChanged, this,
             [this](double current, double duration) {
-                m_sidebar->updateAnimationProgress(current, duration);
+                m_progress.current  = current;
+                m_progress.duration = duration;
+                m_progress.pending  = true;
+                // the first change goes out at once, later ones once per
+                // interval, none while the sidebar is hidden
+                if (m_sidebar->isVisible() && !m_progress.timer->isActive()) {
+                    flushProgress();
+                }
             });
 
     //
@@ -297,13 +477,10 @@ void F3DViewer::initSidebar()
     connect(m_sidebar, &SidebarWnd::sigAnimationLoopChanged, this,
             [this](bool loop) { m_view->setAnimationLoop(loop); });
 
-    connect(m_sidebar, &SidebarWnd::sigShowAxis, this, [this](bool on) {
-        m_view->setOption("ui.axis", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_axis, on);
-            m_ini->sync();
-        }
-    });
+    for (const auto &opt : g_view_options) {
+        connect(m_sidebar, opt.signal, this,
+                [this, &opt](bool on) { setViewOption(opt, on); });
+    }
 
     //
     connect(m_sidebar, &SidebarWnd::sigCameraReset, this,
@@ -324,92 +501,29 @@ void F3DViewer::initSidebar()
         m_view->setYUp(yUp);
         syncSidebar();
     });
-    connect(m_sidebar, &SidebarWnd::sigOrthographicChanged, this,
-            [this](bool on) {
-                m_view->setOption("scene.camera.orthographic", on ? "1" : "0");
-            });
 
     //
-    connect(m_sidebar, &SidebarWnd::sigShowGrid, this, [this](bool on) {
-        m_view->setOption("render.grid.enable", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_grid, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowEdge, this, [this](bool on) {
-        m_view->setOption("render.show_edges", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_edge, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowPointSprites, this, [this](bool on) {
-        m_view->setOption("model.point_sprites.enable", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_point_sprites, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowScalarBar, this, [this](bool on) {
-        m_view->setOption("ui.scalar_bar", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_scalar_bar, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowMetadata, this, [this](bool on) {
-        m_view->setOption("ui.metadata", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_metadata, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowFPS, this, [this](bool on) {
-        m_view->setOption("ui.fps", on ? "1" : "0");
-        if (m_ini) {
-            m_ini->setValue(g_ini_fps, on);
-            m_ini->sync();
-        }
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowAntiAliasing, this, [this](bool on) {
-        m_view->setOption("render.effect.anti_aliasing", on ? "1" : "0");
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowAmbientOcclusion, this,
-            [this](bool on) {
-                m_view->setOption("render.effect.ambient_occlusion",
-                                  on ? "1" : "0");
-            });
-    connect(m_sidebar, &SidebarWnd::sigShowToneMapping, this, [this](bool on) {
-        m_view->setOption("render.effect.tone_mapping", on ? "1" : "0");
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowTranslucencySupport, this,
-            [this](bool on) {
-                m_view->setOption("render.effect.translucency_support",
-                                  on ? "1" : "0");
-            });
     connect(m_sidebar, &SidebarWnd::sigOpacityChanged, this,
             [this](double opacity) {
                 m_view->setOption("model.color.opacity",
                                   QString::number(opacity, 'f', 2));
+                m_state.opacityPercent = opacityPercent(opacity);
             });
-    connect(m_sidebar, &SidebarWnd::sigShowHdriAmbient, this, [this](bool on) {
-        m_view->setOption("render.hdri.ambient", on ? "1" : "0");
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowSkybox, this, [this](bool on) {
-        m_view->setOption("render.background.skybox", on ? "1" : "0");
-    });
-    connect(m_sidebar, &SidebarWnd::sigShowVolumeRendering, this,
-            [this](bool on) {
-                m_view->setOption("model.volume.enable", on ? "1" : "0");
-            });
-    connect(
-        m_sidebar, &SidebarWnd::sigShowBackgroundBlur, this, [this](bool on) {
-            m_view->setOption("render.background.blur.enable", on ? "1" : "0");
-        });
 
     connect(m_sidebar, &SidebarWnd::sigAnimationSpeedChanged, this,
             [this](double speed) { m_view->setAnimationSpeed(speed); });
+    connect(m_sidebar, &SidebarWnd::sigCopyPerformance, this, [this]() {
+        qApp->clipboard()->setText(
+            QString::fromUtf8(f3d::framestats::toJson(m_view->frameStats())));
+    });
+    auto *perf_timer = new QTimer(this);
+    perf_timer->setInterval(g_perf_refresh_ms);
+    connect(perf_timer, &QTimer::timeout, this, [this]() {
+        if (m_sidebar->isVisible()) {
+            m_sidebar->updatePerformance(m_view->frameStats());
+        }
+    });
+    perf_timer->start();
     connect(m_sidebar, &SidebarWnd::sigResetViewOptions, this,
             [this]() { resetViewOptions(); });
 
@@ -419,102 +533,110 @@ void F3DViewer::initSidebar()
 
 void F3DViewer::syncSidebar()
 {
-    if (!m_view) {
+    if (!m_view || m_view->isLoading()) {
         return;
     }
     qprintt << "syncSidebar" << m_view;
 
     SidebarWnd::State state;
-    state.axis = m_view->getOption("ui.axis").toBool();
-    state.grid = m_view->getOption("render.grid.enable").toBool();
-    state.edge = m_view->getOption("render.show_edges").toBool();
-    state.pointSprites
-        = m_view->getOption("model.point_sprites.enable").toBool();
-    state.scalarBar = m_view->getOption("ui.scalar_bar").toBool();
-    state.metadata  = m_view->getOption("ui.metadata").toBool();
-    state.fps       = m_view->getOption("ui.fps").toBool();
-    state.antiAliasing
-        = m_view->getOption("render.effect.anti_aliasing").toBool();
-    state.ambientOcclusion
-        = m_view->getOption("render.effect.ambient_occlusion").toBool();
-    state.toneMapping
-        = m_view->getOption("render.effect.tone_mapping").toBool();
-    state.translucencySupport
-        = m_view->getOption("render.effect.translucency_support").toBool();
-    state.orthographic
-        = m_view->getOption("scene.camera.orthographic").toBool();
-    state.hdriAmbient = m_view->getOption("render.hdri.ambient").toBool();
-    state.skybox      = m_view->getOption("render.background.skybox").toBool();
-    state.volumeRendering = m_view->getOption("model.volume.enable").toBool();
-    state.backgroundBlur
-        = m_view->getOption("render.background.blur.enable").toBool();
+    for (const auto &opt : g_view_options) {
+        state.*opt.field = m_view->getOption(opt.option).toBool();
+    }
     state.animationVisible   = m_view->hasAnimation();
     state.animationRunning   = m_view->isAnimationRunning();
     state.animationLoop      = m_view->isAnimationLoopEnabled();
     state.animationSelection = m_view->getAnimationSelection();
     state.animationSpeed     = m_view->getAnimationSpeed();
     state.yUp                = m_view->isYUp();
-    state.opacityPercent     = qRound(
-        optionDoubleOr(m_view->getOption("model.color.opacity"), 1.0) * 100.0);
+    state.opacityPercent     = opacityPercent(optionDoubleOr(
+        m_view->getOption("model.color.opacity"), g_default_opacity));
 
     m_sidebar->setAnimationList(m_view->getAnimationNames(),
                                 state.animationSelection);
     m_sidebar->syncControls(state);
     m_sidebar->updateAnimationProgress(m_view->getAnimationPosition(),
                                        m_view->getAnimationDuration());
-    if (m_options_ready) {
-        saveDisplayIni();
-        if (m_ini) {
-            m_ini->sync();
+    if (m_options_ready && m_ini) {
+        for (const auto &opt : g_view_options) {
+            if (opt.ini && state.*opt.field != m_state.*opt.field) {
+                setIniValue(opt.ini, state.*opt.field);
+            }
         }
     }
+    m_state = state;
 }
 
-void F3DViewer::resetViewOptions()
+void F3DViewer::syncViewOption(const F3DViewOption &opt)
 {
-    if (!m_view) {
+    if (m_view->isLoading()) {
+        return;
+    }
+    const bool on = m_view->getOption(opt.option).toBool();
+    if (m_state.*opt.field == on) {
         return;
     }
+    m_state.*opt.field = on;
+    m_sidebar->syncControls(m_state);
+    if (opt.ini && m_ini && m_options_ready) {
+        setIniValue(opt.ini, on);
+    }
+}
 
-    const auto d   = defaultViewOptions();
-    auto applyBool = [this](const char *opt, bool on) {
-        m_view->setOption(opt, on ? "1" : "0");
-    };
+void F3DViewer::setViewOption(const F3DViewOption &opt, bool on)
+{
+    m_view->setOption(opt.option, on ? "1" : "0");
+    m_state.*opt.field = on;
+    if (opt.ini && m_ini) {
+        setIniValue(opt.ini, on);
+    }
+}
 
-    applyBool("ui.axis", d.axis);
-    applyBool("render.grid.enable", d.grid);
-    applyBool("render.show_edges", d.edge);
-    applyBool("model.point_sprites.enable", d.pointSprites);
-    applyBool("ui.scalar_bar", d.scalarBar);
-    applyBool("ui.metadata", d.metadata);
-    applyBool("ui.fps", d.fps);
-    applyBool("render.effect.anti_aliasing", d.antiAliasing);
-    applyBool("render.effect.ambient_occlusion", d.ambientOcclusion);
-    applyBool("render.effect.tone_mapping", d.toneMapping);
-    applyBool("render.effect.translucency_support", d.translucency);
-    applyBool("render.hdri.ambient", d.hdriAmbient);
-    applyBool("render.background.skybox", d.skybox);
-    applyBool("model.volume.enable", d.volume);
-    applyBool("render.background.blur.enable", d.backgroundBlur);
-    applyBool("scene.camera.orthographic", d.orthographic);
-    m_view->setOption("model.color.opacity",
-                      QString::number(d.opacity, 'f', 2));
+void F3DViewer::resetViewOptions()
+{
+    if (!m_view) {
+        return;
+    }
 
-    if (m_ini) {
-        m_ini->setValue(g_ini_axis, d.axis);
-        m_ini->setValue(g_ini_grid, d.grid);
-        m_ini->setValue(g_ini_edge, d.edge);
-        m_ini->setValue(g_ini_point_sprites, d.pointSprites);
-        m_ini->setValue(g_ini_scalar_bar, d.scalarBar);
-        m_ini->setValue(g_ini_metadata, d.metadata);
-        m_ini->setValue(g_ini_fps, d.fps);
-        m_ini->sync();
+    for (const auto &opt : g_view_options) {
+        if (m_state.*opt.field != opt.def) {
+            setViewOption(opt, opt.def);
+        }
+    }
+    if (m_state.opacityPercent != opacityPercent(g_default_opacity)) {
+        m_view->setOption("model.color.opacity",
+                          QString::number(g_default_opacity, 'f', 2));
+        m_state.opacityPercent = opacityPercent(g_default_opacity);
     }
 
-    syncSidebar();
+    m_sidebar->syncControls(m_state);
     m_view->update();
 }
 
+void F3DViewer::setIniValue(const QString &key, const QVariant &value)
+{
+    m_ini_pending.insert(key, value);
+    m_ini_flush->start();
+}
+
+QVariant F3DViewer::iniValue(const QString &key, const QVariant &def) const
+{
+    const auto it = m_ini_pending.constFind(key);
+    return it != m_ini_pending.cend() ? *it : m_ini->value(key, def);
+}
+
+void F3DViewer::flushIni()
+{
+    m_ini_flush->stop();
+    if (m_ini_pending.isEmpty()) {
+        return;
+    }
+    for (auto it = m_ini_pending.cbegin(); it != m_ini_pending.cend(); ++it) {
+        m_ini->setValue(it.key(), it.value());
+    }
+    m_ini_pending.clear();
+    m_ini->sync();
+}
+
 void F3DViewer::setSidebarVisible(bool visible)
 {
     if (!m_sidebar) {
@@ -522,12 +644,22 @@ void F3DViewer::setSidebarVisible(bool visible)
     }
     m_sidebar_visible_pref = visible;
     m_sidebar->setVisible(visible);
+    if (visible && m_progress.pending) {
+        flushProgress();
+    }
     if (m_ini) {
-        m_ini->setValue(g_ini_sidebar_visible, visible);
-        m_ini->sync();
+        setIniValue(g_ini_sidebar_visible, visible);
     }
 }
 
+void F3DViewer::flushProgress()
+{
+    m_progress.pending = false;
+    m_progress.timer->start();
+    m_sidebar->updateAnimationProgress(m_progress.current,
+                                       m_progress.duration);
+}
+
 QString F3DViewer::getIniPath() const
 {
     const QString filename = name() % ".ini";
@@ -546,3 +678,170 @@ QString F3DViewer::getIniPath() const
     }
     return dir + filename;
 }
+
+QString F3DViewer::getCacheDir(const QString &sub) const
+{
+    const QString dir = QFileInfo(getIniPath()).absolutePath();
+    return QDir(dir).filePath(name() % "_cache/" % sub);
+}
+
+QByteArray F3DViewer::frameCacheOptions() const
+{
+    QByteArray ret;
+    if (m_ini) {
+        for (const auto &opt : g_view_options) {
+            if (opt.ini) {
+                ret += iniValue(opt.ini).toByteArray() + ';';
+            }
+        }
+    }
+    ret += options()
+               ->property(ViewOptionsKeys::kKeyPluginCmd)
+               .toStringList()
+               .join(' ')
+               .toUtf8();
+    ret += ';' + QByteArray::number(options()->theme());
+    return ret;
+}
+
+void F3DViewer::storeFirstFrame()
+{
+    if (!m_view || m_frame_key.isEmpty()) {
+        return;
+    }
+    const qint64 budget
+        = pluginArgMB(g_arg_frame_cache_budget, g_frame_cache_budget_mb);
+    const QImage frame = m_view->grabFramebuffer();
+    // encoding and eviction stay off the GUI thread
+    (void)QtConcurrent::run(
+        [dir = getCacheDir("frames"), key = m_frame_key, frame, budget]() {
+            f3d::framecache::store(dir, key, frame, budget);
+        });
+}
+
+void F3DViewer::prefetchNeighbours()
+{
+    const qint64 budget
+        = pluginArgMB(g_arg_prefetch_budget, g_prefetch_budget_mb);
+    const QString readers = QDir(getCacheDir({})).filePath("readers.ini");
+    if (budget <= 0) {
+        F3DWidget::prefetch({}, readers, 0);
+        return;
+    }
+    // listing a large folder stays off the GUI thread
+    auto *found = new QFutureWatcher<QStringList>(this);
+    connect(found, &QFutureWatcher<QStringList>::finished, this,
+            [found, readers, budget]() {
+                F3DWidget::prefetch(found->result(), readers, budget);
+                found->deleteLater();
+            });
+    found->setFuture(QtConcurrent::run(f3d::prefetch::neighbours,
+                                       options()->path(), supportedFormats()));
+}
+
+void F3DViewer::sampleRss()
+{
+    m_rss_peak = qMax(m_rss_peak, f3d::metrics::currentRss());
+}
+
+void F3DViewer::reportLoadMetrics(bool ok)
+{
+    if (!m_view || m_metrics_sent) {
+        return;
+    }
+    m_metrics_sent   = true;
+    const auto &info = m_view->loadInfo();
+    m_rss_sampler->stop();
+    sampleRss();
+    // the process wide peak would still show an earlier, larger preview
+    const qint64 peak = qMax(m_rss_peak, info.rssPeak);
+    const QFileInfo file(options()->path());
+    constexpr double mb = 1024. * 1024.;
+    // libf3d 3.x has no API for point and cell counts, the file size and
+    // sniffed format stand in for the scene size
+    const QJsonObject entry{
+        {"time", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"path", file.absoluteFilePath()},
+        {"suffix", file.suffix().toLower()},
+        {"file_bytes", file.size()},
+        {"ok", ok},
+        {"format", info.format},
+        {"reader", info.reader},
+        {"alias", info.alias},
+        {"attempts", info.attempts},
+        {"parse_ms", info.parseMs},
+        {"load_ms", m_load_ms},
+        {"first_frame_ms", ok ? m_load_clock.elapsed() : -1},
+        {"frame_cache_hit", m_frame_cache_hit},
+        {"prefetched", info.prefetched},
+        {"rss_peak_growth_mb", qMax<qint64>(0, peak - m_rss_before) / mb},
+        {"rss_growth_mb",
+         (f3d::metrics::currentRss() - m_rss_before) / mb},
+        {"f3d", f3d::bootstrap::libVersion()},
+    };
+    emit sigLoadMetrics(entry.toVariantMap());
+
+    // rewrites up to g_metrics_max_entries lines, kept off the GUI thread
+    const QString path = QFileInfo(getIniPath()).dir().filePath(
+        name() % "_metrics.jsonl");
+    (void)QtConcurrent::run([path, entry]() {
+        f3d::metrics::append(path, entry, g_metrics_max_entries);
+    });
+}
+
+QString F3DViewer::pluginArg(const QString &key) const
+{
+    const auto cmd
+        = options()->property(ViewOptionsKeys::kKeyPluginCmd).toStringList();
+    for (const auto &[k, v] : F3DWidget::parseOptionArgs(cmd)) {
+        if (k == key) {
+            return v;
+        }
+    }
+    return {};
+}
+
+QString F3DViewer::debugOutputFile(const char *arg,
+                                   const char *env,
+                                   const QString &kind,
+                                   const QString &suffix) const
+{
+    QString file = pluginArg(arg);
+    if (file.isEmpty()) {
+        file = qEnvironmentVariable(env);
+    }
+    if (file.isEmpty() || file == "0") {
+        return {};
+    }
+    if (file == "1" || QFileInfo(file).isDir()) {
+        // Previews opened within the same millisecond get a counter. A trace
+        // is only written when it finishes, so existing files are not enough.
+        static QString lastStamp;
+        static int repeat = 0;
+        const QDir dir(file == "1" ? getCacheDir(kind) : file);
+        const QString stamp
+            = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
+        repeat    = stamp == lastStamp ? repeat + 1 : 0;
+        lastStamp = stamp;
+        for (int i = repeat;; ++i) {
+            file = dir.filePath(
+                i == 0 ? QString("%1_%2.%3").arg(kind, stamp, suffix)
+                       : QString("%1_%2_%3.%4")
+                             .arg(kind, stamp)
+                             .arg(i)
+                             .arg(suffix));
+            if (!QFileInfo::exists(file)) {
+                repeat = i;
+                break;
+            }
+        }
+    }
+    return file;
+}
+
+qint64 F3DViewer::pluginArgMB(const QString &key, qint64 fallback) const
+{
+    bool ok         = false;
+    const qint64 mb = pluginArg(key).toLongLong(&ok);
+    return (ok ? mb : fallback) * 1024 * 1024;
+}
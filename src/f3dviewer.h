@@ -1,11 +1,16 @@
 #pragma once
 
+#include <QElapsedTimer>
+#include <QVariantMap>
+
 #include "seer/viewerbase.h"
+#include "sidebarwnd.h"
 
 class F3DWidget;
-class SidebarWnd;
 class QToolButton;
 class QSettings;
+class QTimer;
+struct F3DViewOption;
 
 class F3DViewer : public ViewerBase {
     Q_OBJECT
@@ -22,6 +27,15 @@ public:
     void updateDPR(qreal) override;
     void updateTheme(int) override;
 
+    // Boolean view options of the sidebar, in table order
+    static QStringList viewOptionKeys();
+
+Q_SIGNALS:
+    // Emitted once per preview with the entry appended to the metrics file.
+    // sigCommand only carries state values and ViewOptions is read only, so
+    // neither can take it.
+    void sigLoadMetrics(const QVariantMap &metrics);
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
 
@@ -30,18 +44,66 @@ protected:
 private:
     void initSidebar();
     void syncSidebar();
+    // Reads back the one option a key press toggled
+    void syncViewOption(const F3DViewOption &opt);
+    void setViewOption(const F3DViewOption &opt, bool on);
     void saveIni();
     void saveDisplayIni();
+    // Held back until INI writes pause for a moment, QSettings would
+    // otherwise write the file on the next event loop pass after each one
+    void setIniValue(const QString &key, const QVariant &value);
+    // Latest value of `key`, pending writes included
+    QVariant iniValue(const QString &key, const QVariant &def = {}) const;
+    // Writes pending values now, ~F3DViewer always ends with it
+    void flushIni();
     void setSidebarVisible(bool visible);
+    // Shows the latest animation progress and starts the rate limit interval
+    void flushProgress();
     void resetViewOptions();
     QString getIniPath() const;
+    QString getCacheDir(const QString &sub) const;
+    QByteArray frameCacheOptions() const;
+    void storeFirstFrame();
+    // Parses the files next to this one ahead of time, see F3DWidget::prefetch
+    void prefetchNeighbours();
+    // Keeps the highest resident set size seen since loadImpl
+    void sampleRss();
+    void reportLoadMetrics(bool ok);
+    QString pluginArg(const QString &key) const;
+    // file named by a plugin arg or environment variable, empty when unset
+    QString debugOutputFile(const char *arg,
+                            const char *env,
+                            const QString &kind,
+                            const QString &suffix) const;
+    qint64 pluginArgMB(const QString &key, qint64 fallback) const;
 
     QSettings *m_ini            = nullptr;
+    QTimer *m_ini_flush         = nullptr;
+    QTimer *m_rss_sampler       = nullptr;
+    QVariantMap m_ini_pending;
     QToolButton *m_btn          = nullptr;
     SidebarWnd *m_sidebar       = nullptr;
     F3DWidget *m_view           = nullptr;
     bool m_sidebar_visible_pref = true;
     bool m_options_ready        = false;
+    QString m_frame_key;
+    // what the sidebar shows, syncs only write what differs from it
+    SidebarWnd::State m_state;
+    struct {
+        QTimer *timer   = nullptr;
+        double current  = 0;
+        double duration = 0;
+        // a change the sidebar has not shown yet
+        bool pending = false;
+    } m_progress;
+    QElapsedTimer m_load_clock;
+    // trace started by this viewer, 0 once written or when disabled
+    quint64 m_trace_session = 0;
+    qint64 m_load_ms        = -1;
+    qint64 m_rss_before     = 0;
+    qint64 m_rss_peak       = 0;
+    bool m_metrics_sent     = false;
+    bool m_frame_cache_hit  = false;
 };
 
 class F3DPlugin : public QObject, public ViewerPluginInterface {
@@ -0,0 +1,227 @@
+#include "F3DBootstrap.h"
+
+#include <f3d/engine.h>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <shared_mutex>
+#if __has_include(<f3d/log.h>)
+#include <f3d/log.h>
+#define F3DVIEWER_HAS_F3D_LOG 1
+#endif
+#include <f3d/options.h>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+
+#include "F3DPathWorkaround.h"
+#include "F3DTrace.h"
+
+#define qprintt qDebug() << "[F3DViewer]"
+
+namespace f3d::bootstrap {
+namespace {
+
+// aliases of a crashed session, a live preview is never this old
+constexpr qint64 g_alias_max_age = 24 * 3600;
+
+#ifdef F3DVIEWER_HAS_F3D_LOG
+void initF3DLogging()
+{
+    f3d::log::setUseColoring(false);
+    f3d::log::forward(
+        [](f3d::log::VerboseLevel level, const std::string &message) {
+            const QString msg = QString::fromStdString(message).trimmed();
+            if (msg.isEmpty()) {
+                return;
+            }
+            switch (level) {
+            case f3d::log::VerboseLevel::DEBUG:
+                // qDebug() << "[F3D] [debug]" << msg;
+                break;
+            case f3d::log::VerboseLevel::INFO:
+                // qInfo() << "[F3D] [info]" << msg;
+                break;
+            case f3d::log::VerboseLevel::WARN:
+                qprintt << "[F3D] [warn]" << msg;
+                break;
+            case f3d::log::VerboseLevel::QUIET:
+                break;
+            default:
+                // case f3d::log::VerboseLevel::ERROR: //compile error
+                qprintt << "[F3D] [error]" << msg;
+            }
+        });
+    f3d::log::setVerboseLevel(f3d::log::VerboseLevel::QUIET, true);
+}
+#endif
+
+// Extensions from bin/plugin.json that need a plugin on top of the native
+// readers built into libf3d
+const QHash<QString, QString> &suffixPlugins()
+{
+    static const QHash<QString, QString> map = {
+        {"abc", "alembic"}, {"3mf", "assimp"},  {"dae", "assimp"},
+        {"dxf", "assimp"},  {"fbx", "assimp"},  {"off", "assimp"},
+        {"x", "assimp"},    {"glb", "draco"},   {"gltf", "draco"},
+        {"e", "hdf"},       {"ex2", "hdf"},     {"exo", "hdf"},
+        {"g", "hdf"},       {"brep", "occt"},   {"igs", "occt"},
+        {"iges", "occt"},   {"step", "occt"},   {"stp", "occt"},
+        {"usd", "usd"},     {"usda", "usd"},    {"usdc", "usd"},
+        {"usdz", "usd"},    {"vdb", "vdb"},
+    };
+    return map;
+}
+
+const QHash<QString, QString> &readerPlugins()
+{
+    static const QHash<QString, QString> map = {
+        {"STEP", "occt"},
+        {"IGES", "occt"},
+        {"BREP", "occt"},
+    };
+    return map;
+}
+
+struct State {
+    State()
+    {
+        QElapsedTimer et;
+        et.start();
+#ifdef F3DVIEWER_HAS_F3D_LOG
+        initF3DLogging();
+#endif
+        version
+            = QString::fromStdString(f3d::engine::getLibInfo().VersionFull);
+
+        auto setUiOpt = [this](const char *key, const char *value) {
+            try {
+                defaults.setAsString(key, value);
+            }
+            catch (...) {
+            }
+        };
+        defaults.render.grid.enable  = true;
+        defaults.ui.axis             = true;
+        defaults.model.color.opacity = 1.0;
+        setUiOpt("scene.animation.indices", "-1");
+        setUiOpt("ui.drop_zone.enable", "0");
+        setUiOpt("ui.drop_zone.show_logo", "0");
+        setUiOpt("ui.notifications.enable", "0");
+        setUiOpt("ui.notifications.show_bindings", "0");
+        setUiOpt("ui.cheatsheet", "0");
+        setUiOpt("ui.console", "0");
+        setUiOpt("ui.minimal_console", "0");
+        setUiOpt("ui.filename", "0");
+        setUiOpt("ui.animation_progress", "0");
+        setUiOpt("ui.loader_progress", "0");
+        const int stale = f3d::workaround::removeStaleAliases(g_alias_max_age);
+        qprintt << "f3d version" << version << "bootstrap" << et.elapsed()
+                << "ms, removed" << stale << "stale aliases";
+    }
+
+    QString version;
+    f3d::options defaults;
+
+    std::mutex pluginMutex;
+    // libf3d's reader registry, see readersLock()
+    std::shared_mutex readers;
+    QSet<QString> plugins;
+    // set once autoloadPlugins() returned, read without pluginMutex
+    std::atomic_bool allPlugins{false};
+};
+
+State &state()
+{
+    static State instance;
+    return instance;
+}
+
+void loadPlugin(const QString &name)
+{
+    auto &st = state();
+    std::lock_guard lock(st.pluginMutex);
+    if (st.allPlugins || st.plugins.contains(name)) {
+        return;
+    }
+    f3d::trace::Scope trace("loadPlugin", name);
+    QElapsedTimer et;
+    et.start();
+    try {
+        std::unique_lock readers(st.readers);
+        f3d::engine::loadPlugin(name.toStdString());
+        qprintt << "loadPlugin" << name << et.elapsed() << "ms";
+    }
+    catch (const std::exception &e) {
+        qprintt << "Error loading plugin" << name << e.what();
+    }
+    st.plugins.insert(name);
+}
+
+}
+
+void init()
+{
+    f3d::trace::Scope trace("bootstrap");
+    state();
+}
+
+QString libVersion()
+{
+    return state().version;
+}
+
+void ensurePluginFor(const QString &path)
+{
+    const auto plugin
+        = suffixPlugins().value(QFileInfo(path).suffix().toLower());
+    if (!plugin.isEmpty()) {
+        loadPlugin(plugin);
+    }
+}
+
+void ensurePluginForReader(const std::string &reader)
+{
+    const auto plugin
+        = readerPlugins().value(QString::fromStdString(reader));
+    if (!plugin.isEmpty()) {
+        loadPlugin(plugin);
+    }
+}
+
+void ensureAllPlugins()
+{
+    auto &st = state();
+    std::lock_guard lock(st.pluginMutex);
+    if (st.allPlugins) {
+        return;
+    }
+    f3d::trace::Scope trace("autoloadPlugins");
+    QElapsedTimer et;
+    et.start();
+    {
+        std::unique_lock readers(st.readers);
+        f3d::engine::autoloadPlugins();
+    }
+    st.allPlugins = true;
+    qprintt << "autoloadPlugins" << et.elapsed() << "ms";
+}
+
+std::shared_lock<std::shared_mutex> readersLock()
+{
+    auto &st = state();
+    if (st.allPlugins) {
+        return {};
+    }
+    return std::shared_lock(st.readers);
+}
+
+void applyDefaultOptions(f3d::engine &engine)
+{
+    engine.setOptions(state().defaults);
+}
+
+}
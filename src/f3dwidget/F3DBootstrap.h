@@ -0,0 +1,36 @@
+#pragma once
+
+#include <shared_mutex>
+#include <string>
+
+#include <QString>
+
+namespace f3d {
+class engine;
+class options;
+}
+
+// Process-lifetime libf3d setup shared by every F3DWidget. Seer creates a new
+// viewer per file, so logging, plugins and the default option set are built on
+// first use and reused afterwards. Safe to call from any thread.
+namespace f3d::bootstrap {
+
+// Logging and default options, plugins are loaded separately
+void init();
+QString libVersion();
+// Loads only the reader plugin serving the extension of `path`
+void ensurePluginFor(const QString &path);
+// Loads the plugin providing a reader forced through scene.force_reader
+void ensurePluginForReader(const std::string &reader);
+void ensureAllPlugins();
+// Held around every scene.add() and scene.supports(): loading a plugin
+// registers readers in libf3d's global registry, which those walk. The
+// ensurePlugin* calls take it exclusively, so never call them while holding
+// it. Once ensureAllPlugins() returned the registry never changes again and
+// the lock returned is empty, so a parse started after that never holds up
+// anyone.
+std::shared_lock<std::shared_mutex> readersLock();
+// Copies the shared viewer defaults into a freshly created engine
+void applyDefaultOptions(f3d::engine &engine);
+
+}
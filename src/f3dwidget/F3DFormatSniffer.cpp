@@ -0,0 +1,126 @@
+#include "F3DFormatSniffer.h"
+
+#include <initializer_list>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QtEndian>
+
+namespace f3d::sniff {
+namespace {
+
+constexpr qint64 g_head_size       = 4096;
+constexpr qint64 g_stl_header_size = 80;
+constexpr qint64 g_stl_facet_size  = 50;
+
+bool isBinaryStl(const QByteArray &head, qint64 fileSize)
+{
+    if (head.size() < g_stl_header_size + 4) {
+        return false;
+    }
+    const auto count = qFromLittleEndian<quint32>(
+        head.constData() + g_stl_header_size);
+    return fileSize == g_stl_header_size + 4 + qint64(count) * g_stl_facet_size;
+}
+
+QString cacheKey(const QString &path, const Format &format)
+{
+    bool ascii = true;
+    for (const QChar ch : path) {
+        if (ch.unicode() > 127) {
+            ascii = false;
+            break;
+        }
+    }
+    // The suffix keeps its case: together with the encoding it decides
+    // whether the ASCII alias retry applies to the file.
+    const QFileInfo info(path);
+    const QString full = info.completeSuffix();
+    return info.suffix() % '/' % format.kind % '/'
+           % (ascii ? "ascii" : "unicode") % '/'
+           % (full == full.toLower() ? "lower" : "mixed");
+}
+
+// Leaves the reader to libf3d when the extension already selects it, so a
+// plugin registered for that extension (e.g. draco for .glb) keeps working.
+void forceUnlessExtensionMatches(Format &format,
+                                 const QString &path,
+                                 const char *reader,
+                                 std::initializer_list<const char *> suffixes)
+{
+    const QString suffix = QFileInfo(path).suffix();
+    for (const char *expected : suffixes) {
+        if (suffix == QLatin1String(expected)) {
+            return;
+        }
+    }
+    format.reader = reader;
+}
+
+}
+
+Format detect(const QString &path)
+{
+    Format ret;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return ret;
+    }
+    const QByteArray head = f.read(g_head_size);
+    const QByteArray text = head.trimmed();
+
+    if (text.startsWith("ISO-10303-21")) {
+        ret.kind = "step";
+        forceUnlessExtensionMatches(ret, path, "STEP", {"step", "stp"});
+    }
+    else if (head.startsWith("glTF")) {
+        ret.kind = "gltf-binary";
+        forceUnlessExtensionMatches(ret, path, "GLTF", {"glb", "gltf"});
+    }
+    else if (head.startsWith("ply\n") || head.startsWith("ply\r\n")) {
+        ret.kind = "ply";
+        forceUnlessExtensionMatches(ret, path, "PLY", {"ply"});
+    }
+    // binary STL headers may start with "solid" too, so the size check wins
+    else if (isBinaryStl(head, f.size())) {
+        ret.kind = "stl-binary";
+        forceUnlessExtensionMatches(ret, path, "STL", {"stl"});
+    }
+    else if (text.startsWith("solid") && head.contains("facet")) {
+        ret.kind = "stl-ascii";
+        forceUnlessExtensionMatches(ret, path, "STL", {"stl"});
+    }
+    return ret;
+}
+
+QString knownFallback(const QString &cacheFile,
+                      const QString &path,
+                      const Format &format)
+{
+    if (cacheFile.isEmpty()) {
+        return {};
+    }
+    const QSettings ini(cacheFile, QSettings::IniFormat);
+    return ini.value(cacheKey(path, format)).toString();
+}
+
+void rememberFallback(const QString &cacheFile,
+                      const QString &path,
+                      const Format &format,
+                      const QString &fallback)
+{
+    if (cacheFile.isEmpty()) {
+        return;
+    }
+    QSettings ini(cacheFile, QSettings::IniFormat);
+    const QString key = cacheKey(path, format);
+    if (fallback.isEmpty()) {
+        ini.remove(key);
+    }
+    else {
+        ini.setValue(key, fallback);
+    }
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <QString>
+
+namespace f3d::sniff {
+
+struct Format {
+    // "step", "gltf-binary", "stl-ascii", "stl-binary", "ply" or "unknown"
+    QString kind = "unknown";
+    // libf3d reader to force, set only when the content is unambiguous and
+    // the extension would not already select that reader
+    std::optional<std::string> reader;
+};
+
+// Looks at the first few KB of `path` instead of trusting its extension.
+Format detect(const QString &path);
+
+// Persistent record of which load attempt succeeded after the default one
+// failed, for files with the same extension and suffix case, format and
+// path encoding.
+// `cacheFile` is an INI file; an empty path disables the cache.
+QString knownFallback(const QString &cacheFile,
+                      const QString &path,
+                      const Format &format);
+void rememberFallback(const QString &cacheFile,
+                      const QString &path,
+                      const Format &format,
+                      const QString &fallback);
+
+}
@@ -0,0 +1,126 @@
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest>
+
+#include "F3DFormatSniffer.h"
+#include "F3DTestUtil.h"
+
+using f3d::testutil::writeFile;
+
+class F3DFormatSnifferTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void detectsStepRegardlessOfExtension();
+    void detectsBinaryStlWithSolidHeader();
+    void detectsAsciiStlAndPly();
+    void leavesMatchingExtensionToLibf3d();
+    void leavesUnknownContentToTheExtension();
+    void remembersFallbackPerExtensionAndEncoding();
+};
+
+void F3DFormatSnifferTest::detectsStepRegardlessOfExtension()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const QString path
+        = writeFile(dir, "part.STP", "\nISO-10303-21;\nHEADER;\nENDSEC;\n");
+    const auto format = f3d::sniff::detect(path);
+    QCOMPARE(format.kind, QString("step"));
+    QCOMPARE(format.reader.value_or(""), std::string("STEP"));
+}
+
+void F3DFormatSnifferTest::detectsBinaryStlWithSolidHeader()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    QByteArray data(80, ' ');
+    data.replace(0, 5, "solid");
+    data.append(4, '\0');
+    qToLittleEndian<quint32>(2, data.data() + 80);
+    data.append(2 * 50, '\0');
+
+    const auto format = f3d::sniff::detect(writeFile(dir, "a.dat", data));
+    QCOMPARE(format.kind, QString("stl-binary"));
+    QCOMPARE(format.reader.value_or(""), std::string("STL"));
+}
+
+void F3DFormatSnifferTest::detectsAsciiStlAndPly()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const auto stl = f3d::sniff::detect(
+        writeFile(dir, "a.txt", "solid a\n facet normal 0 0 1\n"));
+    QCOMPARE(stl.kind, QString("stl-ascii"));
+    QCOMPARE(stl.reader.value_or(""), std::string("STL"));
+
+    const auto ply = f3d::sniff::detect(
+        writeFile(dir, "a.xyz", "ply\nformat ascii 1.0\nend_header\n"));
+    QCOMPARE(ply.kind, QString("ply"));
+    QCOMPARE(ply.reader.value_or(""), std::string("PLY"));
+}
+
+void F3DFormatSnifferTest::leavesMatchingExtensionToLibf3d()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const QByteArray glb("glTF\x02\0\0\0", 8);
+    const auto matching = f3d::sniff::detect(writeFile(dir, "a.glb", glb));
+    QCOMPARE(matching.kind, QString("gltf-binary"));
+    QVERIFY(!matching.reader);
+
+    const auto renamed = f3d::sniff::detect(writeFile(dir, "a.bin", glb));
+    QCOMPARE(renamed.reader.value_or(""), std::string("GLTF"));
+
+    QVERIFY(!f3d::sniff::detect(
+                 writeFile(dir, "a.stl", "solid a\n facet normal 0 0 1\n"))
+                 .reader);
+}
+
+void F3DFormatSnifferTest::leavesUnknownContentToTheExtension()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const auto format
+        = f3d::sniff::detect(writeFile(dir, "a.obj", "v 0 0 0\nv 1 0 0\n"));
+    QCOMPARE(format.kind, QString("unknown"));
+    QVERIFY(!format.reader);
+
+    QVERIFY(!f3d::sniff::detect(dir.filePath("missing.obj")).reader);
+}
+
+void F3DFormatSnifferTest::remembersFallbackPerExtensionAndEncoding()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary cache directory should be created");
+
+    const QString cache = dir.filePath("readers.ini");
+    const f3d::sniff::Format format;
+    const QString ascii   = dir.filePath("a.fbx");
+    const QString unicode = dir.filePath(QString::fromUtf8("模型.fbx"));
+
+    QVERIFY(f3d::sniff::knownFallback(cache, ascii, format).isEmpty());
+    f3d::sniff::rememberFallback(cache, unicode, format, "alias");
+    QCOMPARE(f3d::sniff::knownFallback(cache, unicode, format),
+             QString("alias"));
+    QVERIFY(f3d::sniff::knownFallback(cache, ascii, format).isEmpty());
+
+    // an upper case suffix makes the alias retry apply, so it is kept apart
+    const QString upper = dir.filePath("b.FBX");
+    f3d::sniff::rememberFallback(cache, upper, format, "alias");
+    QCOMPARE(f3d::sniff::knownFallback(cache, upper, format), QString("alias"));
+    QVERIFY(f3d::sniff::knownFallback(cache, ascii, format).isEmpty());
+
+    f3d::sniff::rememberFallback(cache, unicode, format, {});
+    QVERIFY(f3d::sniff::knownFallback(cache, unicode, format).isEmpty());
+    QVERIFY(f3d::sniff::knownFallback({}, unicode, format).isEmpty());
+}
+
+QTEST_APPLESS_MAIN(F3DFormatSnifferTest)
+
+#include "F3DFormatSniffer_test.moc"
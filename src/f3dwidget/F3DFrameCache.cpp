@@ -0,0 +1,101 @@
+#include "F3DFrameCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+
+#define qprintt qDebug() << "[F3DViewer]"
+
+namespace f3d::framecache {
+namespace {
+
+constexpr auto g_suffix = ".png";
+
+QString entryPath(const QString &dir, const QString &key)
+{
+    return QDir(dir).filePath(key + g_suffix);
+}
+
+void evict(const QString &dir, qint64 budgetBytes)
+{
+    // mtime is bumped on every hit, so oldest first is least recently used
+    const auto entries = QDir(dir).entryInfoList(
+        {QString("*") + g_suffix}, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 used = 0;
+    for (const auto &info : entries) {
+        used += info.size();
+    }
+    for (const auto &info : entries) {
+        if (used <= budgetBytes) {
+            break;
+        }
+        if (QFile::remove(info.absoluteFilePath())) {
+            used -= info.size();
+        }
+    }
+}
+
+}
+
+QString key(const QString &path, const QByteArray &options)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(
+        QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(options);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QImage load(const QString &dir, const QString &key)
+{
+    if (key.isEmpty()) {
+        return {};
+    }
+    const QString path = entryPath(dir, key);
+    QImageReader reader(path);
+    const QImage img = reader.read();
+    if (img.isNull()) {
+        qprintt << "frame cache miss" << key;
+        return {};
+    }
+    QFile f(path);
+    if (f.open(QIODevice::ReadWrite)) {
+        f.setFileTime(QDateTime::currentDateTime(),
+                      QFileDevice::FileModificationTime);
+    }
+    qprintt << "frame cache hit" << key;
+    return img;
+}
+
+bool store(const QString &dir,
+           const QString &key,
+           const QImage &frame,
+           qint64 budgetBytes)
+{
+    if (key.isEmpty() || frame.isNull() || budgetBytes <= 0) {
+        return false;
+    }
+    QDir().mkpath(dir);
+    QSaveFile f(entryPath(dir, key));
+    if (!f.open(QIODevice::WriteOnly)
+        || !frame.convertToFormat(QImage::Format_RGB888).save(&f, "PNG")
+        || !f.commit()) {
+        qprintt << "frame cache store failed" << key;
+        return false;
+    }
+    evict(dir, budgetBytes);
+    return true;
+}
+
+}
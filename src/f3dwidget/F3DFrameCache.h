@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+
+namespace f3d::framecache {
+
+// Identifies a rendered first frame: file path, size and mtime plus whatever
+// the caller passes as `options` (display flags, plugin args, theme...).
+// Returns an empty key when the file does not exist.
+QString key(const QString &path, const QByteArray &options);
+
+// Returns a null image on miss.
+QImage load(const QString &dir, const QString &key);
+// Writes the frame and evicts the least recently used entries until the
+// directory is below `budgetBytes`.
+bool store(const QString &dir,
+           const QString &key,
+           const QImage &frame,
+           qint64 budgetBytes);
+
+}
@@ -0,0 +1,86 @@
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "F3DFrameCache.h"
+#include "F3DTestUtil.h"
+
+using f3d::testutil::writeFile;
+
+class F3DFrameCacheTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void keyChangesWithOptionsAndContent();
+    void storesAndLoadsFrame();
+    void evictsOldestEntriesOverBudget();
+};
+
+namespace {
+
+QImage frame(int w, int h)
+{
+    QImage img(w, h, QImage::Format_RGB888);
+    img.fill(Qt::darkCyan);
+    return img;
+}
+
+}
+
+void F3DFrameCacheTest::keyChangesWithOptionsAndContent()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const QString path = writeFile(dir, "a.stl", "solid a");
+    QVERIFY(!path.isEmpty());
+
+    const QString key = f3d::framecache::key(path, "grid=1");
+    QVERIFY(!key.isEmpty());
+    QCOMPARE(f3d::framecache::key(path, "grid=1"), key);
+    QVERIFY(f3d::framecache::key(path, "grid=0") != key);
+
+    writeFile(dir, "a.stl", "solid ab");
+    QVERIFY(f3d::framecache::key(path, "grid=1") != key);
+
+    QVERIFY(f3d::framecache::key(dir.filePath("missing.stl"), {}).isEmpty());
+}
+
+void F3DFrameCacheTest::storesAndLoadsFrame()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary cache directory should be created");
+
+    const QString cache = dir.filePath("frames");
+    QVERIFY(f3d::framecache::load(cache, "k").isNull());
+    QVERIFY(f3d::framecache::store(cache, "k", frame(64, 32), 1 << 20));
+
+    const QImage img = f3d::framecache::load(cache, "k");
+    QCOMPARE(img.size(), QSize(64, 32));
+}
+
+void F3DFrameCacheTest::evictsOldestEntriesOverBudget()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary cache directory should be created");
+
+    const QString cache = dir.filePath("frames");
+    QVERIFY(f3d::framecache::store(cache, "old", frame(256, 256), 1 << 20));
+    QFile old(QDir(cache).filePath("old.png"));
+    QVERIFY(old.open(QIODevice::ReadWrite));
+    QVERIFY(old.setFileTime(QDateTime::currentDateTime().addDays(-1),
+                            QFileDevice::FileModificationTime));
+    old.close();
+
+    const qint64 one = QFileInfo(old).size();
+    QVERIFY(f3d::framecache::store(cache, "new", frame(256, 256), one + 1));
+
+    QVERIFY(f3d::framecache::load(cache, "old").isNull());
+    QVERIFY(!f3d::framecache::load(cache, "new").isNull());
+}
+
+QTEST_APPLESS_MAIN(F3DFrameCacheTest)
+
+#include "F3DFrameCache_test.moc"
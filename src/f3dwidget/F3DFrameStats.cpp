@@ -0,0 +1,120 @@
+#include "F3DFrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <QJsonDocument>
+
+namespace f3d::framestats {
+namespace {
+
+// Both durations fit a float, packed so a sample is one lock-free word
+std::uint64_t pack(float cpu, float interval)
+{
+    std::uint32_t a = 0;
+    std::uint32_t b = 0;
+    std::memcpy(&a, &cpu, sizeof(a));
+    std::memcpy(&b, &interval, sizeof(b));
+    return (std::uint64_t(a) << 32) | b;
+}
+
+void unpack(std::uint64_t word, float &cpu, float &interval)
+{
+    const auto a = std::uint32_t(word >> 32);
+    const auto b = std::uint32_t(word);
+    std::memcpy(&cpu, &a, sizeof(a));
+    std::memcpy(&interval, &b, sizeof(b));
+}
+
+// nearest-rank percentiles
+Percentiles percentiles(std::vector<float> values)
+{
+    Percentiles ret;
+    if (values.empty()) {
+        return ret;
+    }
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double p) {
+        const auto n   = values.size();
+        const auto idx = std::size_t(std::ceil(p / 100. * n));
+        return double(values[std::clamp<std::size_t>(idx, 1, n) - 1]);
+    };
+    ret.p50 = rank(50);
+    ret.p95 = rank(95);
+    ret.p99 = rank(99);
+    return ret;
+}
+
+}
+
+void Recorder::record(double cpuMs, double intervalMs)
+{
+    if (intervalMs > idleGapMs) {
+        intervalMs = -1;
+    }
+    const auto head = m_head.load(std::memory_order_relaxed);
+    m_samples[head % capacity].store(pack(float(cpuMs), float(intervalMs)),
+                                     std::memory_order_relaxed);
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+Summary Recorder::summary() const
+{
+    const auto head = m_head.load(std::memory_order_acquire);
+    const auto n    = int(std::min<std::uint64_t>(head, capacity));
+    std::vector<float> cpu;
+    std::vector<float> intervals;
+    cpu.reserve(n);
+    intervals.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        float c  = 0;
+        float iv = 0;
+        unpack(m_samples[i].load(std::memory_order_relaxed), c, iv);
+        cpu.push_back(c);
+        if (iv >= 0) {
+            intervals.push_back(iv);
+        }
+    }
+
+    Summary ret;
+    ret.frames   = n;
+    ret.cpu      = percentiles(cpu);
+    ret.interval = percentiles(intervals);
+    for (const float iv : intervals) {
+        if (iv > 2 * ret.interval.p50) {
+            ++ret.hitches;
+        }
+    }
+    return ret;
+}
+
+void Recorder::clear()
+{
+    m_head.store(0, std::memory_order_release);
+}
+
+QJsonObject toJsonObject(const Percentiles &percentiles)
+{
+    return {{"p50", percentiles.p50},
+            {"p95", percentiles.p95},
+            {"p99", percentiles.p99}};
+}
+
+QJsonObject toJsonObject(const Summary &summary)
+{
+    return {
+        {"frames", summary.frames},
+        {"cpu_ms", toJsonObject(summary.cpu)},
+        {"interval_ms", toJsonObject(summary.interval)},
+        {"hitches", summary.hitches},
+    };
+}
+
+QByteArray toJson(const Summary &summary)
+{
+    return QJsonDocument(toJsonObject(summary)).toJson(QJsonDocument::Indented);
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace f3d::framestats {
+
+struct Percentiles {
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+};
+
+struct Summary {
+    int frames = 0;
+    // time spent in paintGL() on the CPU
+    Percentiles cpu;
+    // time between two presented frames, idle gaps excluded
+    Percentiles interval;
+    // intervals longer than twice the median interval
+    int hitches = 0;
+};
+
+// Fixed-size history of the last frames. record() is meant for the GUI
+// thread only, summary() may run on any thread without locking: each sample
+// is a single atomic word, so readers never see a half written entry.
+class Recorder {
+public:
+    static constexpr int capacity = 1024;
+    // intervals above this are pauses of the on-demand rendering, not frames
+    static constexpr double idleGapMs = 500;
+
+    // `intervalMs` < 0 when there is no previous frame to measure against
+    void record(double cpuMs, double intervalMs);
+    Summary summary() const;
+    void clear();
+
+private:
+    std::array<std::atomic<std::uint64_t>, capacity> m_samples{};
+    std::atomic<std::uint64_t> m_head{0};
+};
+
+QJsonObject toJsonObject(const Percentiles &percentiles);
+QJsonObject toJsonObject(const Summary &summary);
+QByteArray toJson(const Summary &summary);
+
+}
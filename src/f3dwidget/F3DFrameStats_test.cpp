@@ -0,0 +1,86 @@
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtTest>
+
+#include "F3DFrameStats.h"
+
+class F3DFrameStatsTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void computesNearestRankPercentiles();
+    void countsHitchesAgainstTheMedianInterval();
+    void ignoresIdleGapsBetweenFrames();
+    void keepsOnlyTheMostRecentFrames();
+    void exportsJson();
+};
+
+void F3DFrameStatsTest::computesNearestRankPercentiles()
+{
+    f3d::framestats::Recorder rec;
+    for (int i = 1; i <= 100; ++i) {
+        rec.record(i, 16);
+    }
+    const auto s = rec.summary();
+    QCOMPARE(s.frames, 100);
+    QCOMPARE(s.cpu.p50, 50.);
+    QCOMPARE(s.cpu.p95, 95.);
+    QCOMPARE(s.cpu.p99, 99.);
+    QCOMPARE(s.interval.p50, 16.);
+    QCOMPARE(s.hitches, 0);
+}
+
+void F3DFrameStatsTest::countsHitchesAgainstTheMedianInterval()
+{
+    f3d::framestats::Recorder rec;
+    for (int i = 0; i < 20; ++i) {
+        rec.record(1, i % 10 == 9 ? 100 : 10);
+    }
+    QCOMPARE(rec.summary().hitches, 2);
+}
+
+void F3DFrameStatsTest::ignoresIdleGapsBetweenFrames()
+{
+    f3d::framestats::Recorder rec;
+    rec.record(2, -1);
+    rec.record(2, 10);
+    rec.record(2, 60000);
+    rec.record(2, 10);
+    const auto s = rec.summary();
+    QCOMPARE(s.frames, 4);
+    QCOMPARE(s.interval.p99, 10.);
+    QCOMPARE(s.hitches, 0);
+}
+
+void F3DFrameStatsTest::keepsOnlyTheMostRecentFrames()
+{
+    f3d::framestats::Recorder rec;
+    const int cap = f3d::framestats::Recorder::capacity;
+    for (int i = 0; i < cap; ++i) {
+        rec.record(1000, 16);
+    }
+    for (int i = 0; i < cap; ++i) {
+        rec.record(1, 16);
+    }
+    QCOMPARE(rec.summary().frames, cap);
+    QCOMPARE(rec.summary().cpu.p99, 1.);
+
+    rec.clear();
+    QCOMPARE(rec.summary().frames, 0);
+}
+
+void F3DFrameStatsTest::exportsJson()
+{
+    f3d::framestats::Recorder rec;
+    rec.record(4, 16);
+    const auto doc = QJsonDocument::fromJson(
+        f3d::framestats::toJson(rec.summary()));
+    QVERIFY(doc.isObject());
+    QCOMPARE(doc["frames"].toInt(), 1);
+    QCOMPARE(doc["cpu_ms"]["p50"].toDouble(), 4.);
+    QCOMPARE(doc["interval_ms"]["p95"].toDouble(), 16.);
+}
+
+QTEST_APPLESS_MAIN(F3DFrameStatsTest)
+
+#include "F3DFrameStats_test.moc"
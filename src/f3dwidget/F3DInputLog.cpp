@@ -0,0 +1,280 @@
+#include "F3DInputLog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QSaveFile>
+#include <QWheelEvent>
+
+#define qprintt qDebug() << "[F3DViewer]"
+
+namespace f3d::input {
+namespace {
+
+constexpr int g_version = 1;
+
+const QList<QPair<QEvent::Type, QString>> &typeNames()
+{
+    static const QList<QPair<QEvent::Type, QString>> names = {
+        {QEvent::MouseButtonPress, "press"},
+        {QEvent::MouseButtonRelease, "release"},
+        {QEvent::MouseMove, "move"},
+        {QEvent::MouseButtonDblClick, "dblclick"},
+        {QEvent::Wheel, "wheel"},
+        {QEvent::KeyPress, "key"},
+        {QEvent::Resize, "resize"},
+    };
+    return names;
+}
+
+QString typeName(QEvent::Type type)
+{
+    for (const auto &[t, name] : typeNames()) {
+        if (t == type) {
+            return name;
+        }
+    }
+    return {};
+}
+
+QEvent::Type typeFromName(const QString &name)
+{
+    for (const auto &[t, n] : typeNames()) {
+        if (n == name) {
+            return t;
+        }
+    }
+    return QEvent::None;
+}
+
+bool isMouse(QEvent::Type type)
+{
+    return type == QEvent::MouseButtonPress
+           || type == QEvent::MouseButtonRelease
+           || type == QEvent::MouseMove
+           || type == QEvent::MouseButtonDblClick;
+}
+
+QByteArray headerLine(const QSize &size, const QString &model)
+{
+    const QJsonObject header{
+        {"version", g_version},
+        {"size", QJsonArray{size.width(), size.height()}},
+        {"model", model},
+    };
+    return QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray eventLine(const Event &event)
+{
+    return QJsonDocument(toJson(event)).toJson(QJsonDocument::Compact) + '\n';
+}
+
+}
+
+std::optional<Event> fromQEvent(const QEvent *event, qint64 time)
+{
+    Event ret;
+    ret.time = time;
+    ret.type = event->type();
+    if (isMouse(ret.type)) {
+        const auto *e = static_cast<const QMouseEvent *>(event);
+        // hover moves do not touch the camera
+        if (ret.type == QEvent::MouseMove && e->buttons() == Qt::NoButton) {
+            return std::nullopt;
+        }
+        ret.pos       = e->position();
+        ret.button    = e->button();
+        ret.buttons   = e->buttons();
+        ret.modifiers = e->modifiers();
+        return ret;
+    }
+    if (ret.type == QEvent::Wheel) {
+        const auto *e  = static_cast<const QWheelEvent *>(event);
+        ret.pos        = e->position();
+        ret.buttons    = e->buttons();
+        ret.modifiers  = e->modifiers();
+        ret.angleDelta = e->angleDelta();
+        return ret;
+    }
+    if (ret.type == QEvent::KeyPress) {
+        const auto *e = static_cast<const QKeyEvent *>(event);
+        ret.key       = e->key();
+        ret.modifiers = e->modifiers();
+        ret.text      = e->text();
+        return ret;
+    }
+    if (ret.type == QEvent::Resize) {
+        ret.size = static_cast<const QResizeEvent *>(event)->size();
+        return ret;
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<QEvent> toQEvent(const Event &event)
+{
+    if (isMouse(event.type)) {
+        return std::make_unique<QMouseEvent>(event.type, event.pos, event.pos,
+                                             event.button, event.buttons,
+                                             event.modifiers);
+    }
+    if (event.type == QEvent::Wheel) {
+        return std::make_unique<QWheelEvent>(
+            event.pos, event.pos, QPoint(), event.angleDelta, event.buttons,
+            event.modifiers, Qt::NoScrollPhase, false);
+    }
+    if (event.type == QEvent::KeyPress) {
+        return std::make_unique<QKeyEvent>(event.type, event.key,
+                                           event.modifiers, event.text);
+    }
+    return nullptr;
+}
+
+QJsonObject toJson(const Event &event)
+{
+    QJsonObject obj{
+        {"t", event.time},
+        {"type", typeName(event.type)},
+    };
+    if (event.modifiers != Qt::NoModifier) {
+        obj["mods"] = int(event.modifiers.toInt());
+    }
+    if (event.type == QEvent::KeyPress) {
+        obj["key"] = event.key;
+        if (!event.text.isEmpty()) {
+            obj["text"] = event.text;
+        }
+        return obj;
+    }
+    if (event.type == QEvent::Resize) {
+        obj["w"] = event.size.width();
+        obj["h"] = event.size.height();
+        return obj;
+    }
+    obj["x"] = event.pos.x();
+    obj["y"] = event.pos.y();
+    if (event.button != Qt::NoButton) {
+        obj["button"] = int(event.button);
+    }
+    if (event.buttons != Qt::NoButton) {
+        obj["buttons"] = int(event.buttons.toInt());
+    }
+    if (event.type == QEvent::Wheel) {
+        obj["dx"] = event.angleDelta.x();
+        obj["dy"] = event.angleDelta.y();
+    }
+    return obj;
+}
+
+std::optional<Event> fromJson(const QJsonObject &obj)
+{
+    Event ret;
+    ret.type = typeFromName(obj["type"].toString());
+    if (ret.type == QEvent::None) {
+        return std::nullopt;
+    }
+    ret.time       = qint64(obj["t"].toDouble());
+    ret.modifiers  = Qt::KeyboardModifiers::fromInt(obj["mods"].toInt());
+    ret.pos        = QPointF(obj["x"].toDouble(), obj["y"].toDouble());
+    ret.button     = Qt::MouseButton(obj["button"].toInt());
+    ret.buttons    = Qt::MouseButtons::fromInt(obj["buttons"].toInt());
+    ret.angleDelta = QPoint(obj["dx"].toInt(), obj["dy"].toInt());
+    ret.key        = obj["key"].toInt();
+    ret.text       = obj["text"].toString();
+    ret.size       = QSize(obj["w"].toInt(), obj["h"].toInt());
+    if (ret.type == QEvent::Resize && ret.size.isEmpty()) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+std::optional<Recording> load(const QString &file)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    const auto lines = f.readAll().split('\n');
+    if (lines.isEmpty()) {
+        return std::nullopt;
+    }
+    const auto header = QJsonDocument::fromJson(lines.first()).object();
+    if (header["version"].toInt() != g_version) {
+        qprintt << "Unsupported input recording" << file;
+        return std::nullopt;
+    }
+    Recording ret;
+    const auto size = header["size"].toArray();
+    ret.size        = QSize(size.at(0).toInt(), size.at(1).toInt());
+    ret.model       = header["model"].toString();
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        if (lines[i].trimmed().isEmpty()) {
+            continue;
+        }
+        if (auto event = fromJson(QJsonDocument::fromJson(lines[i]).object())) {
+            ret.events.append(*event);
+        }
+    }
+    return ret;
+}
+
+bool save(const QString &file, const Recording &recording)
+{
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    QSaveFile out(file);
+    if (!out.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    out.write(headerLine(recording.size, recording.model));
+    for (const auto &event : recording.events) {
+        out.write(eventLine(event));
+    }
+    return out.commit();
+}
+
+Recorder::Recorder(const QString &file,
+                   const QSize &size,
+                   const QString &model)
+    : m_file(file)
+{
+    m_clock.start();
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    // unbuffered, each line reaches the OS in one write
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate
+                     | QIODevice::Unbuffered)
+        || m_file.write(headerLine(size, model)) < 0) {
+        qprintt << "Error writing input recording" << file;
+        m_file.close();
+    }
+}
+
+Recorder::~Recorder()
+{
+    if (m_file.isOpen()) {
+        qprintt << "input recorded" << m_file.fileName() << m_count
+                << "events";
+    }
+}
+
+void Recorder::record(const QEvent *event)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (auto e = fromQEvent(event, m_clock.elapsed())) {
+        if (m_file.write(eventLine(*e)) < 0) {
+            qprintt << "Error writing input recording" << m_file.fileName();
+            m_file.close();
+            return;
+        }
+        ++m_count;
+    }
+}
+
+}
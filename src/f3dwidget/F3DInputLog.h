@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QJsonObject>
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QSize>
+#include <QString>
+
+// Timestamped mouse, wheel, key and resize events of an F3DWidget, stored as
+// JSON Lines: a header with the widget size and model, then one event per line.
+// Replay goes through the same widget as a live session: mouse moves are
+// queued and applied once per painted frame, and interaction quality follows
+// frame timing, so the camera path and the rendered frames only approximate
+// the recorded session. It is meant for comparable benchmark runs, not for
+// pixel-exact reproduction.
+namespace f3d::input {
+
+struct Event {
+    // milliseconds since the recording started
+    qint64 time       = 0;
+    QEvent::Type type = QEvent::None;
+    QPointF pos;
+    Qt::MouseButton button          = Qt::NoButton;
+    Qt::MouseButtons buttons        = Qt::NoButton;
+    Qt::KeyboardModifiers modifiers = Qt::NoModifier;
+    QPoint angleDelta;
+    int key = 0;
+    QString text;
+    // new widget size of a resize
+    QSize size;
+};
+
+struct Recording {
+    QSize size;
+    QString model;
+    QList<Event> events;
+};
+
+// Input events the widget reacts to and resizes, std::nullopt for
+// everything else
+std::optional<Event> fromQEvent(const QEvent *event, qint64 time);
+// nullptr for resizes, a replay applies those with QWidget::resize()
+std::unique_ptr<QEvent> toQEvent(const Event &event);
+
+QJsonObject toJson(const Event &event);
+std::optional<Event> fromJson(const QJsonObject &obj);
+
+std::optional<Recording> load(const QString &file);
+bool save(const QString &file, const Recording &recording);
+
+// Appends events to `file` as they are recorded, so a crash or a hang that
+// gets the process killed keeps everything up to that point
+class Recorder {
+public:
+    Recorder(const QString &file, const QSize &size, const QString &model);
+    ~Recorder();
+
+    void record(const QEvent *event);
+
+private:
+    QFile m_file;
+    qsizetype m_count = 0;
+    QElapsedTimer m_clock;
+};
+
+}
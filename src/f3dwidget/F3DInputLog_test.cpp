@@ -0,0 +1,113 @@
+#include <QKeyEvent>
+#include <QResizeEvent>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "F3DInputLog.h"
+
+class F3DInputLogTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void roundTripsEventsThroughJson();
+    void convertsKeyEvents();
+    void savesAndLoadsRecordings();
+    void recordsResizes();
+    void appendsWhileRecording();
+};
+
+void F3DInputLogTest::roundTripsEventsThroughJson()
+{
+    f3d::input::Event drag;
+    drag.time      = 42;
+    drag.type      = QEvent::MouseMove;
+    drag.pos       = {12.5, 30};
+    drag.buttons   = Qt::LeftButton;
+    drag.modifiers = Qt::ShiftModifier;
+
+    const auto back = f3d::input::fromJson(f3d::input::toJson(drag));
+    QVERIFY(back);
+    QCOMPARE(back->time, qint64(42));
+    QCOMPARE(back->type, QEvent::MouseMove);
+    QCOMPARE(back->pos, QPointF(12.5, 30));
+    QCOMPARE(back->buttons, Qt::MouseButtons(Qt::LeftButton));
+    QCOMPARE(back->modifiers, Qt::KeyboardModifiers(Qt::ShiftModifier));
+
+    QVERIFY(!f3d::input::fromJson({{"type", "resize"}}));
+}
+
+void F3DInputLogTest::convertsKeyEvents()
+{
+    const QKeyEvent key(QEvent::KeyPress, Qt::Key_A, Qt::ControlModifier, "a");
+    const auto event = f3d::input::fromQEvent(&key, 7);
+    QVERIFY(event);
+    QCOMPARE(event->key, int(Qt::Key_A));
+    QCOMPARE(event->text, QString("a"));
+
+    const auto replayed = f3d::input::toQEvent(*event);
+    QVERIFY(replayed);
+    const auto *back = static_cast<const QKeyEvent *>(replayed.get());
+    QCOMPARE(back->key(), int(Qt::Key_A));
+    QCOMPARE(back->modifiers(), Qt::KeyboardModifiers(Qt::ControlModifier));
+
+    const QEvent other(QEvent::Enter);
+    QVERIFY(!f3d::input::fromQEvent(&other, 0));
+}
+
+void F3DInputLogTest::savesAndLoadsRecordings()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary recording directory should be created");
+
+    f3d::input::Recording rec{QSize(640, 480), "model.glb", {}};
+    f3d::input::Event wheel;
+    wheel.time       = 100;
+    wheel.type       = QEvent::Wheel;
+    wheel.angleDelta = {0, -120};
+    rec.events << wheel;
+
+    const QString file = dir.filePath("sub/input.jsonl");
+    QVERIFY(f3d::input::save(file, rec));
+    const auto loaded = f3d::input::load(file);
+    QVERIFY(loaded);
+    QCOMPARE(loaded->size, QSize(640, 480));
+    QCOMPARE(loaded->model, QString("model.glb"));
+    QCOMPARE(int(loaded->events.size()), 1);
+    QCOMPARE(loaded->events.first().angleDelta, QPoint(0, -120));
+}
+
+void F3DInputLogTest::recordsResizes()
+{
+    const QResizeEvent resize(QSize(800, 600), QSize(640, 480));
+    const auto event = f3d::input::fromQEvent(&resize, 5);
+    QVERIFY(event);
+    QCOMPARE(event->size, QSize(800, 600));
+    QVERIFY(!f3d::input::toQEvent(*event));
+
+    const auto back = f3d::input::fromJson(f3d::input::toJson(*event));
+    QVERIFY(back);
+    QCOMPARE(back->type, QEvent::Resize);
+    QCOMPARE(back->size, QSize(800, 600));
+}
+
+void F3DInputLogTest::appendsWhileRecording()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary recording directory should be created");
+
+    const QString file = dir.filePath("input.jsonl");
+    f3d::input::Recorder recorder(file, QSize(640, 480), "model.glb");
+    const QKeyEvent key(QEvent::KeyPress, Qt::Key_G, Qt::NoModifier, "g");
+    recorder.record(&key);
+
+    // read back while the recorder is still alive, as after a crash
+    const auto loaded = f3d::input::load(file);
+    QVERIFY(loaded);
+    QCOMPARE(loaded->size, QSize(640, 480));
+    QCOMPARE(int(loaded->events.size()), 1);
+    QCOMPARE(loaded->events.first().key, int(Qt::Key_G));
+}
+
+QTEST_APPLESS_MAIN(F3DInputLogTest)
+
+#include "F3DInputLog_test.moc"
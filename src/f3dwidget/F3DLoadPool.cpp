@@ -0,0 +1,106 @@
+#include "F3DLoadPool.h"
+
+#include <mutex>
+#include <utility>
+
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace f3d::loadpool {
+
+struct Ticket {
+    std::mutex mutex;
+    bool started      = false;
+    bool done         = false;
+    bool orphan       = false;
+    QThreadPool *pool = nullptr;
+    // owned by the pool while queued, deleted by it once run
+    QRunnable *runnable = nullptr;
+};
+
+namespace {
+
+std::mutex g_orphans_mutex;
+int g_orphans = 0;
+
+// An orphan holds an extra thread on top of the pool's own bound, false
+// when `maxOrphans` are already in flight
+bool setOrphan(QThreadPool &pool, bool add)
+{
+    std::lock_guard lock(g_orphans_mutex);
+    if (add && g_orphans >= maxOrphans) {
+        return false;
+    }
+    g_orphans += add ? 1 : -1;
+    pool.setMaxThreadCount(pool.maxThreadCount() + (add ? 1 : -1));
+    return true;
+}
+
+}
+
+QThreadPool &pool()
+{
+    // Never destroyed: waiting for orphaned parses would stall app exit
+    static QThreadPool *instance = []() {
+        auto *ret = new QThreadPool;
+        ret->setMaxThreadCount(maxThreads);
+        return ret;
+    }();
+    return *instance;
+}
+
+QThreadPool &background()
+{
+    static QThreadPool *instance = []() {
+        auto *ret = new QThreadPool;
+        ret->setMaxThreadCount(1);
+        ret->setThreadPriority(QThread::LowestPriority);
+        return ret;
+    }();
+    return *instance;
+}
+
+std::shared_ptr<Ticket> start(std::function<void()> task, QThreadPool &on)
+{
+    auto ticket      = std::make_shared<Ticket>();
+    ticket->pool     = &on;
+    ticket->runnable = QRunnable::create([ticket, task = std::move(task)]() {
+        {
+            std::lock_guard lock(ticket->mutex);
+            ticket->started = true;
+        }
+        task();
+        std::lock_guard lock(ticket->mutex);
+        ticket->done = true;
+        if (ticket->orphan) {
+            setOrphan(*ticket->pool, false);
+        }
+    });
+    on.start(ticket->runnable);
+    return ticket;
+}
+
+bool drop(Ticket &ticket)
+{
+    std::lock_guard lock(ticket.mutex);
+    // a runnable that is not started yet is still alive, so tryTake() never
+    // sees a deleted one
+    if (ticket.started || !ticket.runnable
+        || !ticket.pool->tryTake(ticket.runnable)) {
+        return false;
+    }
+    delete std::exchange(ticket.runnable, nullptr);
+    return true;
+}
+
+bool abandon(Ticket &ticket)
+{
+    std::lock_guard lock(ticket.mutex);
+    if (!ticket.started || ticket.done || ticket.orphan) {
+        return false;
+    }
+    ticket.orphan = setOrphan(*ticket.pool, true);
+    return ticket.orphan;
+}
+
+}
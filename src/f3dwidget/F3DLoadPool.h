@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+class QThreadPool;
+
+// Threads for scene parses only. An abandoned scene.add() cannot be
+// interrupted and keeps its thread until it returns, so no other work is
+// ever queued behind one. Live loads get `maxThreads` threads; a running
+// parse handed to abandon() stops counting against them, up to
+// `maxOrphans` of them, so browsing quickly never queues the visible load
+// behind wasted work. Loads abandoned before a thread picked them up are
+// dropped without running.
+namespace f3d::loadpool {
+
+constexpr int maxThreads = 2;
+// Abandoned parses running beside the live loads, a further one keeps its
+// live slot until it returns
+constexpr int maxOrphans = 2;
+
+QThreadPool &pool();
+// One low priority thread for parses nobody waits for yet, so speculative
+// work never holds up a load
+QThreadPool &background();
+
+// A queued task, see drop()
+struct Ticket;
+std::shared_ptr<Ticket> start(std::function<void()> task,
+                              QThreadPool &on = pool());
+// Takes the task off the queue, true when no thread had started it: it then
+// never runs. False once it is running or done.
+bool drop(Ticket &ticket);
+// Gives the thread of a running task back to live loads while it finishes,
+// false when it is not running or `maxOrphans` are already in flight
+bool abandon(Ticket &ticket);
+
+}
@@ -0,0 +1,165 @@
+#include <atomic>
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtTest>
+
+#include "F3DLoadPool.h"
+
+class F3DLoadPoolTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void abandonedLoadDoesNotDelayTheNext();
+    void isolatedFromTheGlobalPool();
+    void boundsConcurrentParses();
+    void orphansKeepASlotForTheActiveLoad();
+    void dropsQueuedLoads();
+};
+
+namespace {
+
+constexpr int g_wait_ms = 2000;
+
+}
+
+void F3DLoadPoolTest::abandonedLoadDoesNotDelayTheNext()
+{
+    auto &pool = f3d::loadpool::pool();
+    QSemaphore release;
+    QSemaphore finished;
+
+    // a slow parse whose widget is gone, it only returns when released
+    pool.start([&release, &finished]() {
+        release.acquire();
+        finished.release();
+    });
+    pool.start([&finished]() { finished.release(); });
+
+    QVERIFY2(finished.tryAcquire(1, g_wait_ms),
+             "the next load should run while the abandoned one is parsing");
+    QCOMPARE(finished.available(), 0);
+
+    release.release();
+    QVERIFY(finished.tryAcquire(1, g_wait_ms));
+    QVERIFY(pool.waitForDone(g_wait_ms));
+}
+
+void F3DLoadPoolTest::isolatedFromTheGlobalPool()
+{
+    auto *global = QThreadPool::globalInstance();
+    QVERIFY(&f3d::loadpool::pool() != global);
+
+    // thumbnails and metrics occupying every global thread
+    QSemaphore release;
+    const int busy = global->maxThreadCount();
+    for (int i = 0; i < busy; ++i) {
+        global->start([&release]() { release.acquire(); });
+    }
+
+    QSemaphore loaded;
+    f3d::loadpool::pool().start([&loaded]() { loaded.release(); });
+    const bool ok = loaded.tryAcquire(1, g_wait_ms);
+
+    release.release(busy);
+    QVERIFY(global->waitForDone(g_wait_ms));
+    QVERIFY2(ok, "a load should not wait for the global pool");
+}
+
+void F3DLoadPoolTest::boundsConcurrentParses()
+{
+    auto &pool = f3d::loadpool::pool();
+    QCOMPARE(pool.maxThreadCount(), f3d::loadpool::maxThreads);
+
+    // abandoned parses that only return when released, one more than fits
+    QSemaphore release;
+    QSemaphore running;
+    const int count = f3d::loadpool::maxThreads + 1;
+    for (int i = 0; i < count; ++i) {
+        f3d::loadpool::start([&release, &running]() {
+            running.release();
+            release.acquire();
+        });
+    }
+
+    QVERIFY(running.tryAcquire(f3d::loadpool::maxThreads, g_wait_ms));
+    QVERIFY2(!running.tryAcquire(1, 100),
+             "a load beyond the bound should wait for a thread");
+    QVERIFY(pool.activeThreadCount() <= f3d::loadpool::maxThreads);
+
+    release.release(count);
+    QVERIFY(running.tryAcquire(1, g_wait_ms));
+    QVERIFY(pool.waitForDone(g_wait_ms));
+}
+
+void F3DLoadPoolTest::orphansKeepASlotForTheActiveLoad()
+{
+    using namespace f3d::loadpool;
+    QSemaphore release;
+    QSemaphore running;
+    // browsing quickly: as many abandoned parses in flight as live threads
+    QList<std::shared_ptr<Ticket>> orphans;
+    for (int i = 0; i < maxThreads; ++i) {
+        orphans << start([&release, &running]() {
+            running.release();
+            release.acquire();
+        });
+    }
+    QVERIFY(running.tryAcquire(maxThreads, g_wait_ms));
+    for (const auto &ticket : orphans) {
+        QVERIFY(abandon(*ticket));
+        QVERIFY(!abandon(*ticket));
+    }
+
+    QSemaphore loaded;
+    start([&loaded]() { loaded.release(); });
+    QVERIFY2(loaded.tryAcquire(1, g_wait_ms),
+             "the visible load should not queue behind abandoned parses");
+
+    // beyond maxOrphans a parse keeps its live slot
+    auto extra = start([&release, &running]() {
+        running.release();
+        release.acquire();
+    });
+    QVERIFY(running.tryAcquire(1, g_wait_ms));
+    QCOMPARE(abandon(*extra), maxOrphans > maxThreads);
+
+    release.release(maxThreads + 1);
+    QVERIFY(pool().waitForDone(g_wait_ms));
+    QCOMPARE(pool().maxThreadCount(), maxThreads);
+}
+
+void F3DLoadPoolTest::dropsQueuedLoads()
+{
+    auto &pool = f3d::loadpool::pool();
+    QSemaphore release;
+    QSemaphore running;
+    for (int i = 0; i < f3d::loadpool::maxThreads; ++i) {
+        f3d::loadpool::start([&release, &running]() {
+            running.release();
+            release.acquire();
+        });
+    }
+    QVERIFY(running.tryAcquire(f3d::loadpool::maxThreads, g_wait_ms));
+
+    std::atomic_bool ran{false};
+    auto queued = f3d::loadpool::start([&ran]() { ran = true; });
+    QVERIFY2(f3d::loadpool::drop(*queued),
+             "a load that has not started should be taken off the queue");
+    QVERIFY(!f3d::loadpool::drop(*queued));
+
+    release.release(f3d::loadpool::maxThreads);
+    QVERIFY(pool.waitForDone(g_wait_ms));
+    QVERIFY(!ran);
+
+    // once started, a load can no longer be dropped
+    QSemaphore done;
+    auto started = f3d::loadpool::start([&done]() { done.release(); });
+    QVERIFY(done.tryAcquire(1, g_wait_ms));
+    QVERIFY(!f3d::loadpool::drop(*started));
+    QVERIFY(pool.waitForDone(g_wait_ms));
+}
+
+QTEST_APPLESS_MAIN(F3DLoadPoolTest)
+
+#include "F3DLoadPool_test.moc"
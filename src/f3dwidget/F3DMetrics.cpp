@@ -0,0 +1,101 @@
+#include "F3DMetrics.h"
+
+#include <mutex>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace f3d::metrics {
+namespace {
+
+std::mutex &fileMutex()
+{
+    static std::mutex instance;
+    return instance;
+}
+
+}
+
+qint64 currentRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return qint64(pmc.WorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile f("/proc/self/statm");
+    if (!f.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const auto fields = f.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    return fields[1].toLongLong() * ::sysconf(_SC_PAGESIZE);
+#else
+    // no portable current value, the peak is the closest upper bound
+    return peakRss();
+#endif
+}
+
+qint64 peakRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return qint64(pmc.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef Q_OS_MACOS
+    return qint64(usage.ru_maxrss);
+#else
+    // kilobytes everywhere but macOS
+    return qint64(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+bool append(const QString &file, const QJsonObject &entry, int maxEntries)
+{
+    std::lock_guard lock(fileMutex());
+    QList<QByteArray> lines;
+    {
+        QFile in(file);
+        if (in.open(QIODevice::ReadOnly)) {
+            lines = in.readAll().split('\n');
+        }
+    }
+    lines.removeAll(QByteArray());
+    lines.append(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+    if (lines.size() > maxEntries) {
+        lines.erase(lines.begin(), lines.end() - qMax(0, maxEntries));
+    }
+
+    QSaveFile out(file);
+    if (!out.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (const auto &line : lines) {
+        out.write(line);
+        out.write("\n");
+    }
+    return out.commit();
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+// Per-preview load metrics kept in a local JSON Lines file, one object per
+// preview, so slow files and formats can be found after the fact.
+namespace f3d::metrics {
+
+// Resident set size of this process in bytes, 0 when unknown
+qint64 currentRss();
+// Highest resident set size reached by this process so far
+qint64 peakRss();
+
+// Appends `entry` to `file` and drops the oldest lines beyond `maxEntries`.
+// Serialized across threads, safe to call from a worker.
+bool append(const QString &file, const QJsonObject &entry, int maxEntries);
+
+}
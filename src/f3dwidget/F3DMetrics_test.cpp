@@ -0,0 +1,43 @@
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "F3DMetrics.h"
+
+class F3DMetricsTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void reportsProcessMemory();
+    void keepsOnlyTheNewestEntries();
+};
+
+void F3DMetricsTest::reportsProcessMemory()
+{
+    QVERIFY(f3d::metrics::currentRss() > 0);
+    QVERIFY(f3d::metrics::peakRss() >= f3d::metrics::currentRss());
+}
+
+void F3DMetricsTest::keepsOnlyTheNewestEntries()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary metrics directory should be created");
+
+    const QString file = dir.filePath("metrics.jsonl");
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(f3d::metrics::append(file, {{"index", i}}, 3));
+    }
+
+    QFile f(file);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const auto lines = f.readAll().trimmed().split('\n');
+    QCOMPARE(int(lines.size()), 3);
+    QCOMPARE(QJsonDocument::fromJson(lines.first())["index"].toInt(), 2);
+    QCOMPARE(QJsonDocument::fromJson(lines.last())["index"].toInt(), 4);
+}
+
+QTEST_APPLESS_MAIN(F3DMetricsTest)
+
+#include "F3DMetrics_test.moc"
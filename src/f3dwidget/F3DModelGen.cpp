@@ -0,0 +1,386 @@
+#include "F3DModelGen.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QtMath>
+
+namespace f3d::modelgen {
+namespace {
+
+constexpr double g_wave      = 0.1;
+constexpr double g_frequency = 6.0;
+// keyframes of the animated glTF, one full turn around Z
+constexpr int g_anim_keys        = 5;
+constexpr double g_anim_duration = 2.0;
+// glTF component types
+constexpr int g_gl_float        = 5126;
+constexpr int g_gl_unsigned_int = 5125;
+
+// Grid of side x side vertices, 2 * (side - 1)^2 triangles
+struct Grid {
+    explicit Grid(qint64 triangles)
+    {
+        side = qint64(std::ceil(std::sqrt(double(triangles) / 2.))) + 1;
+        side = std::max<qint64>(side, 2);
+    }
+
+    qint64 vertices() const
+    {
+        return side * side;
+    }
+    qint64 triangles() const
+    {
+        return 2 * (side - 1) * (side - 1);
+    }
+    void vertex(qint64 i, qint64 j, float out[3]) const
+    {
+        const double x = double(i) / double(side - 1);
+        const double y = double(j) / double(side - 1);
+
+        out[0] = float(x);
+        out[1] = float(y);
+        out[2] = float(g_wave * std::sin(g_frequency * x)
+                       * std::cos(g_frequency * y));
+    }
+
+    qint64 side = 2;
+};
+
+void putFloat(QByteArray &buf, float v)
+{
+    char raw[4];
+    qToLittleEndian(v, raw);
+    buf.append(raw, 4);
+}
+
+void putUInt(QByteArray &buf, quint32 v)
+{
+    char raw[4];
+    qToLittleEndian(v, raw);
+    buf.append(raw, 4);
+}
+
+bool flush(QFile &f, QByteArray &buf)
+{
+    const bool ok = f.write(buf) == buf.size();
+    buf.clear();
+    return ok;
+}
+
+bool writeStl(const QString &path, const Grid &grid)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QByteArray buf = QByteArray("f3dviewer_bench").leftJustified(80, '\0');
+    putUInt(buf, quint32(grid.triangles()));
+    auto facet = [&buf](const float *a, const float *b, const float *c) {
+        for (int k = 0; k < 3; ++k) {
+            putFloat(buf, 0.f);
+        }
+        for (const float *v : {a, b, c}) {
+            putFloat(buf, v[0]);
+            putFloat(buf, v[1]);
+            putFloat(buf, v[2]);
+        }
+        buf.append(2, '\0');
+    };
+    float v00[3], v10[3], v01[3], v11[3];
+    for (qint64 j = 0; j + 1 < grid.side; ++j) {
+        for (qint64 i = 0; i + 1 < grid.side; ++i) {
+            grid.vertex(i, j, v00);
+            grid.vertex(i + 1, j, v10);
+            grid.vertex(i, j + 1, v01);
+            grid.vertex(i + 1, j + 1, v11);
+            facet(v00, v10, v11);
+            facet(v00, v11, v01);
+        }
+        if (!flush(f, buf)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writePly(const QString &path, qint64 points)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QByteArray buf = QString("ply\nformat binary_little_endian 1.0\n"
+                             "element vertex %1\n"
+                             "property float x\nproperty float y\n"
+                             "property float z\nend_header\n")
+                         .arg(points)
+                         .toLatin1();
+    const auto side = qint64(std::ceil(std::sqrt(double(points))));
+    const Grid grid(2 * (side - 1) * (side - 1));
+    float v[3];
+    for (qint64 k = 0; k < points; ++k) {
+        grid.vertex(k % side, k / side, v);
+        putFloat(buf, v[0]);
+        putFloat(buf, v[1]);
+        putFloat(buf, v[2]);
+        if (k % side == side - 1 && !flush(f, buf)) {
+            return false;
+        }
+    }
+    return flush(f, buf);
+}
+
+bool writeObj(const QString &path, const Grid &grid)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QByteArray buf = "# f3dviewer_bench\n";
+    float v[3];
+    for (qint64 j = 0; j < grid.side; ++j) {
+        for (qint64 i = 0; i < grid.side; ++i) {
+            grid.vertex(i, j, v);
+            buf.append("v ");
+            buf.append(QByteArray::number(v[0], 'g', 7) + ' ');
+            buf.append(QByteArray::number(v[1], 'g', 7) + ' ');
+            buf.append(QByteArray::number(v[2], 'g', 7) + '\n');
+        }
+        if (!flush(f, buf)) {
+            return false;
+        }
+    }
+    for (qint64 j = 0; j + 1 < grid.side; ++j) {
+        for (qint64 i = 0; i + 1 < grid.side; ++i) {
+            // OBJ indices are 1-based
+            const qint64 a = j * grid.side + i + 1;
+            const qint64 b = a + 1;
+            const qint64 c = a + grid.side;
+            const qint64 d = c + 1;
+            buf.append(QString("f %1 %2 %3\nf %1 %3 %4\n")
+                           .arg(a)
+                           .arg(b)
+                           .arg(d)
+                           .arg(c)
+                           .toLatin1());
+        }
+        if (!flush(f, buf)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// .gltf JSON next to an external .bin: positions, indices, then the optional
+// keyframe times and rotations
+bool writeGltf(const QString &path, const Grid &grid, bool animated)
+{
+    const QString binName = QFileInfo(path).completeBaseName() + ".bin";
+    QFile bin(QFileInfo(path).dir().filePath(binName));
+    if (!bin.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QByteArray buf;
+    float v[3];
+    for (qint64 j = 0; j < grid.side; ++j) {
+        for (qint64 i = 0; i < grid.side; ++i) {
+            grid.vertex(i, j, v);
+            putFloat(buf, v[0]);
+            putFloat(buf, v[1]);
+            putFloat(buf, v[2]);
+        }
+        if (!flush(bin, buf)) {
+            return false;
+        }
+    }
+    for (qint64 j = 0; j + 1 < grid.side; ++j) {
+        for (qint64 i = 0; i + 1 < grid.side; ++i) {
+            const auto a = quint32(j * grid.side + i);
+            const auto b = a + 1;
+            const auto c = a + quint32(grid.side);
+            const auto d = c + 1;
+            for (const quint32 idx : {a, b, d, a, d, c}) {
+                putUInt(buf, idx);
+            }
+        }
+        if (!flush(bin, buf)) {
+            return false;
+        }
+    }
+    const qint64 posBytes = grid.vertices() * 3 * 4;
+    const qint64 idxBytes = grid.triangles() * 3 * 4;
+    if (animated) {
+        for (int k = 0; k < g_anim_keys; ++k) {
+            putFloat(buf, float(g_anim_duration * k / (g_anim_keys - 1)));
+        }
+        for (int k = 0; k < g_anim_keys; ++k) {
+            // quaternion (x, y, z, w) of a rotation around Z
+            const double half = qDegreesToRadians(180. * k / (g_anim_keys - 1));
+            putFloat(buf, 0.f);
+            putFloat(buf, 0.f);
+            putFloat(buf, float(std::sin(half)));
+            putFloat(buf, float(std::cos(half)));
+        }
+        if (!flush(bin, buf)) {
+            return false;
+        }
+    }
+    const qint64 binBytes = bin.size();
+    bin.close();
+
+    QJsonArray views{
+        QJsonObject{{"buffer", 0}, {"byteOffset", 0}, {"byteLength", posBytes}},
+        QJsonObject{{"buffer", 0},
+                    {"byteOffset", posBytes},
+                    {"byteLength", idxBytes}},
+    };
+    QJsonArray accessors{
+        QJsonObject{{"bufferView", 0},
+                    {"componentType", g_gl_float},
+                    {"count", grid.vertices()},
+                    {"type", "VEC3"},
+                    {"min", QJsonArray{0, 0, -g_wave}},
+                    {"max", QJsonArray{1, 1, g_wave}}},
+        QJsonObject{{"bufferView", 1},
+                    {"componentType", g_gl_unsigned_int},
+                    {"count", grid.triangles() * 3},
+                    {"type", "SCALAR"}},
+    };
+    QJsonObject root{
+        {"asset", QJsonObject{{"version", "2.0"},
+                              {"generator", "f3dviewer_bench"}}},
+        {"scene", 0},
+        {"scenes", QJsonArray{QJsonObject{{"nodes", QJsonArray{0}}}}},
+        {"nodes", QJsonArray{QJsonObject{{"mesh", 0}}}},
+        {"meshes",
+         QJsonArray{QJsonObject{
+             {"primitives",
+              QJsonArray{QJsonObject{
+                  {"attributes", QJsonObject{{"POSITION", 0}}},
+                  {"indices", 1}}}}}}},
+        {"buffers",
+         QJsonArray{QJsonObject{{"uri", binName}, {"byteLength", binBytes}}}},
+    };
+    if (animated) {
+        const qint64 timeOffset = posBytes + idxBytes;
+        const qint64 timeBytes  = g_anim_keys * 4;
+        views.append(QJsonObject{{"buffer", 0},
+                                 {"byteOffset", timeOffset},
+                                 {"byteLength", timeBytes}});
+        views.append(QJsonObject{{"buffer", 0},
+                                 {"byteOffset", timeOffset + timeBytes},
+                                 {"byteLength", g_anim_keys * 4 * 4}});
+        accessors.append(QJsonObject{{"bufferView", 2},
+                                     {"componentType", g_gl_float},
+                                     {"count", g_anim_keys},
+                                     {"type", "SCALAR"},
+                                     {"min", QJsonArray{0}},
+                                     {"max", QJsonArray{g_anim_duration}}});
+        accessors.append(QJsonObject{{"bufferView", 3},
+                                     {"componentType", g_gl_float},
+                                     {"count", g_anim_keys},
+                                     {"type", "VEC4"}});
+        root["animations"] = QJsonArray{QJsonObject{
+            {"name", "spin"},
+            {"samplers", QJsonArray{QJsonObject{{"input", 2}, {"output", 3}}}},
+            {"channels",
+             QJsonArray{QJsonObject{
+                 {"sampler", 0},
+                 {"target",
+                  QJsonObject{{"node", 0}, {"path", "rotation"}}}}}}}};
+    }
+    root["bufferViews"] = views;
+    root["accessors"]   = accessors;
+
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return f.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) > 0;
+}
+
+QString suffix(Kind kind)
+{
+    switch (kind) {
+    case Kind::StlBinary:
+        return "stl";
+    case Kind::PlyPoints:
+        return "ply";
+    case Kind::Obj:
+        return "obj";
+    case Kind::Gltf:
+    case Kind::GltfAnimated:
+        return "gltf";
+    }
+    return {};
+}
+
+}
+
+QString kindName(Kind kind)
+{
+    switch (kind) {
+    case Kind::StlBinary:
+        return "stl";
+    case Kind::PlyPoints:
+        return "ply-points";
+    case Kind::Obj:
+        return "obj";
+    case Kind::Gltf:
+        return "gltf";
+    case Kind::GltfAnimated:
+        return "gltf-animated";
+    }
+    return {};
+}
+
+Model generate(const QString &dir, Kind kind, qint64 primitives)
+{
+    Model ret;
+    ret.kind     = kind;
+    ret.animated = kind == Kind::GltfAnimated;
+    const Grid grid(primitives);
+    ret.primitives = kind == Kind::PlyPoints ? primitives : grid.triangles();
+    ret.name       = QString("%1_%2").arg(kindName(kind)).arg(primitives);
+
+    QDir().mkpath(dir);
+    const QString path = QDir(dir).filePath(ret.name + "." + suffix(kind));
+    if (QFileInfo::exists(path)) {
+        ret.path = path;
+        return ret;
+    }
+
+    bool ok = false;
+    switch (kind) {
+    case Kind::StlBinary:
+        ok = writeStl(path, grid);
+        break;
+    case Kind::PlyPoints:
+        ok = writePly(path, primitives);
+        break;
+    case Kind::Obj:
+        ok = writeObj(path, grid);
+        break;
+    case Kind::Gltf:
+    case Kind::GltfAnimated:
+        ok = writeGltf(path, grid, ret.animated);
+        break;
+    }
+    if (!ok) {
+        // never leave a truncated file behind for the next run to reuse
+        QFile::remove(path);
+        return ret;
+    }
+    ret.path = path;
+    return ret;
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QString>
+
+// Procedural models for benchmarking. Files are streamed row by row, so even
+// the largest grades never hold the whole mesh in memory.
+namespace f3d::modelgen {
+
+enum class Kind {
+    StlBinary,
+    PlyPoints,
+    Obj,
+    Gltf,
+    GltfAnimated,
+};
+
+struct Model {
+    QString path;
+    QString name;
+    Kind kind = Kind::StlBinary;
+    // triangles, or points for point clouds
+    qint64 primitives = 0;
+    bool animated     = false;
+};
+
+QString kindName(Kind kind);
+
+// Writes a wavy grid surface (or point cloud) with at least `primitives`
+// triangles or points into `dir`. An existing file with the same name is
+// reused. Returns an empty path on I/O errors.
+Model generate(const QString &dir, Kind kind, qint64 primitives);
+
+}
@@ -0,0 +1,92 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "F3DModelGen.h"
+
+using f3d::modelgen::Kind;
+
+class F3DModelGenTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void writesBinaryStlOfTheRequestedSize();
+    void writesExactPointCount();
+    void writesGltfWithExternalBufferAndAnimation();
+    void reusesExistingFiles();
+};
+
+void F3DModelGenTest::writesBinaryStlOfTheRequestedSize()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary output directory should be created");
+
+    const auto model
+        = f3d::modelgen::generate(dir.path(), Kind::StlBinary, 1000);
+    QVERIFY(!model.path.isEmpty());
+    QVERIFY(model.primitives >= 1000);
+    QCOMPARE(QFileInfo(model.path).size(), 84 + 50 * model.primitives);
+}
+
+void F3DModelGenTest::writesExactPointCount()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary output directory should be created");
+
+    const auto model
+        = f3d::modelgen::generate(dir.path(), Kind::PlyPoints, 777);
+    QCOMPARE(model.primitives, qint64(777));
+    QFile f(model.path);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QByteArray data = f.readAll();
+    QVERIFY(data.contains("element vertex 777\n"));
+    const qint64 header = data.indexOf("end_header\n") + 11;
+    QCOMPARE(qint64(data.size()) - header, qint64(777 * 12));
+}
+
+void F3DModelGenTest::writesGltfWithExternalBufferAndAnimation()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary output directory should be created");
+
+    const auto model
+        = f3d::modelgen::generate(dir.path(), Kind::GltfAnimated, 200);
+    QVERIFY(model.animated);
+    QFile f(model.path);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const auto root   = QJsonDocument::fromJson(f.readAll()).object();
+    const auto buffer = root["buffers"].toArray().first().toObject();
+    const QFileInfo bin(QDir(dir.path()).filePath(buffer["uri"].toString()));
+    QVERIFY(bin.exists());
+    QCOMPARE(qint64(buffer["byteLength"].toDouble()), bin.size());
+    QCOMPARE(int(root["animations"].toArray().size()), 1);
+    const auto indices = root["accessors"].toArray().at(1).toObject();
+    QCOMPARE(qint64(indices["count"].toDouble()), model.primitives * 3);
+}
+
+void F3DModelGenTest::reusesExistingFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary output directory should be created");
+
+    const auto first = f3d::modelgen::generate(dir.path(), Kind::Obj, 50);
+    {
+        QFile f(first.path);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write("marker");
+    }
+    const auto second = f3d::modelgen::generate(dir.path(), Kind::Obj, 50);
+    QCOMPARE(second.path, first.path);
+    QFile f(second.path);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    QCOMPARE(f.readAll(), QByteArray("marker"));
+}
+
+QTEST_APPLESS_MAIN(F3DModelGenTest)
+
+#include "F3DModelGen_test.moc"
@@ -1,28 +1,130 @@
 #include "F3DPathWorkaround.h"
 
+#ifdef Q_OS_WIN
 #include <windows.h>
-
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/clonefile.h>
+#endif
+#endif
+
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QRandomGenerator>
 
 namespace f3d::workaround {
 namespace {
 
+constexpr auto g_alias_prefix = "seer_f3d_";
+// new names to try when a random alias name is already taken
+constexpr int g_alias_attempts = 8;
+// digits of the random part of an alias name
+constexpr int g_alias_random_len = 16;
+
+// set by setTempAliasRoot(), empty for the default location
+QString g_root_override;
+
 QString ensureTempAliasRoot()
 {
-    const QString root = QDir::cleanPath(
-        QDir(QDir::tempPath()).filePath("Seer/autodel"));
+    const QString root
+        = g_root_override.isEmpty()
+              ? QDir::cleanPath(QDir(QDir::tempPath()).filePath("Seer/autodel"))
+              : QDir::cleanPath(g_root_override);
     QDir().mkpath(root);
     return root;
 }
 
-QString aliasNameFor(const QFileInfo &info, int index)
+// seer_f3d_<creation time>_<random>.<ext>: hard links share the timestamps of
+// their source, so the name is the only reliable record of the alias age
+QString uniqueAliasName(const QFileInfo &info)
 {
     const QString ext    = info.completeSuffix().toLower();
     const QString dotExt = ext.isEmpty() ? QString() : "." + ext;
-    return QString("seer_f3d_%1%2").arg(index, 2, 10, QChar('0')).arg(dotExt);
+    return QString("%1%2_%3%4")
+        .arg(g_alias_prefix)
+        .arg(QDateTime::currentSecsSinceEpoch(), 0, 16)
+        .arg(QRandomGenerator::global()->generate64(), g_alias_random_len, 16,
+             QChar('0'))
+        .arg(dotExt);
+}
+
+enum class LinkResult { Created, Exists, Failed };
+
+// Every strategy shares the source data, none of them copies file contents.
+// Creation fails instead of overwriting, which makes the name claim atomic.
+#ifdef Q_OS_WIN
+LinkResult linkAlias(const QString &src, const QString &alias)
+{
+    const auto wsrc   = reinterpret_cast<LPCWSTR>(src.utf16());
+    const auto walias = reinterpret_cast<LPCWSTR>(alias.utf16());
+    if (CreateHardLinkW(walias, wsrc, nullptr)) {
+        return LinkResult::Created;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        return LinkResult::Exists;
+    }
+    // hard links cannot cross volumes; symlinks need developer mode or admin
+    if (CreateSymbolicLinkW(walias, wsrc,
+                            SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE)) {
+        return LinkResult::Created;
+    }
+    return GetLastError() == ERROR_ALREADY_EXISTS ? LinkResult::Exists
+                                                  : LinkResult::Failed;
+}
+#else
+bool reflink(const QByteArray &src, const QByteArray &alias)
+{
+#if defined(Q_OS_LINUX)
+    const int in = ::open(src.constData(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        return false;
+    }
+    const int out = ::open(alias.constData(),
+                           O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (out < 0) {
+        const int err = errno;
+        ::close(in);
+        errno = err;
+        return false;
+    }
+    const bool ok = ::ioctl(out, FICLONE, in) == 0;
+    ::close(out);
+    ::close(in);
+    if (!ok) {
+        ::unlink(alias.constData());
+        errno = EXDEV;
+    }
+    return ok;
+#elif defined(Q_OS_MACOS)
+    return ::clonefile(src.constData(), alias.constData(), 0) == 0;
+#else
+    Q_UNUSED(src);
+    Q_UNUSED(alias);
+    errno = ENOTSUP;
+    return false;
+#endif
+}
+
+LinkResult linkAlias(const QString &src, const QString &alias)
+{
+    const QByteArray s = QFile::encodeName(src);
+    const QByteArray a = QFile::encodeName(alias);
+    // hard link, then copy-on-write clone across volumes, then symlink
+    if (::link(s.constData(), a.constData()) == 0 || reflink(s, a)
+        || ::symlink(s.constData(), a.constData()) == 0) {
+        return LinkResult::Created;
+    }
+    return errno == EEXIST ? LinkResult::Exists : LinkResult::Failed;
 }
+#endif
 
 }
 
@@ -31,10 +133,16 @@ QString tempAliasRoot()
     return ensureTempAliasRoot();
 }
 
+void setTempAliasRoot(const QString &root)
+{
+    g_root_override = root;
+}
+
 QString normalizeLoadPath(const QString &path)
 {
     const QFileInfo info(path);
     const QString absolute = info.absoluteFilePath();
+#ifdef Q_OS_WIN
     const QString native   = QDir::toNativeSeparators(absolute);
     std::wstring wide      = native.toStdWString();
     std::wstring shortPath(MAX_PATH, L'\0');
@@ -52,6 +160,7 @@ QString normalizeLoadPath(const QString &path)
     if (!originalSuffix.compare(shortenedSuffix, Qt::CaseInsensitive)) {
         return shortened;
     }
+#endif
 
     return absolute;
 }
@@ -66,25 +175,45 @@ QString createAsciiAlias(const QString &path)
     const QString root = ensureTempAliasRoot();
     const QString src  = QDir::toNativeSeparators(info.absoluteFilePath());
 
-    for (int i = 0; i < 64; ++i) {
-        const QString aliasPath = QDir(root).filePath(aliasNameFor(info, i));
-        if (QFileInfo::exists(aliasPath)) {
+    for (int i = 0; i < g_alias_attempts; ++i) {
+        const QString aliasPath = QDir(root).filePath(uniqueAliasName(info));
+        switch (linkAlias(src, QDir::toNativeSeparators(aliasPath))) {
+        case LinkResult::Created:
+            return aliasPath;
+        case LinkResult::Exists:
             continue;
+        case LinkResult::Failed:
+            return {};
         }
+    }
 
-        const QString nativeAlias = QDir::toNativeSeparators(aliasPath);
-        if (CreateHardLinkW(reinterpret_cast<LPCWSTR>(nativeAlias.utf16()),
-                            reinterpret_cast<LPCWSTR>(src.utf16()),
-                            nullptr)) {
-            return aliasPath;
-        }
+    return {};
+}
 
-        if (QFile::copy(info.absoluteFilePath(), aliasPath)) {
-            return aliasPath;
+int removeStaleAliases(qint64 maxAgeSecs)
+{
+    const qint64 cutoff = QDateTime::currentSecsSinceEpoch() - maxAgeSecs;
+    const int prefixLen = QString(g_alias_prefix).size();
+    const QDir root(ensureTempAliasRoot());
+    // QDir::System keeps dangling symlink aliases in the listing
+    const auto names = root.entryList({QString(g_alias_prefix) + "*"},
+                                      QDir::Files | QDir::System);
+    int removed = 0;
+    for (const auto &name : names) {
+        // <creation time>_<random>, anything else is not ours to age
+        const QString stem = name.mid(prefixLen).section('.', 0, 0);
+        const QString rand = stem.section('_', 1);
+        bool ok            = false;
+        const qint64 stamp = stem.section('_', 0, 0).toLongLong(&ok, 16);
+        if (!ok || rand.size() != g_alias_random_len) {
+            continue;
+        }
+        rand.toULongLong(&ok, 16);
+        if (ok && stamp < cutoff && QFile::remove(root.filePath(name))) {
+            ++removed;
         }
     }
-
-    return {};
+    return removed;
 }
 
 }
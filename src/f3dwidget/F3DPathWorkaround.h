@@ -5,7 +5,19 @@
 namespace f3d::workaround {
 
 QString tempAliasRoot();
+// Moves aliases under `root` instead of Seer/autodel in the temp directory,
+// an empty string restores the default. Meant for tests, call it before any
+// alias is created or cleaned up.
+void setTempAliasRoot(const QString &root);
 QString normalizeLoadPath(const QString &path);
+// Links `path` under tempAliasRoot() with an ASCII name and a lowercase
+// extension. Never copies the file; returns an empty string when no link
+// kind is available.
 QString createAsciiAlias(const QString &path);
+// Removes aliases older than `maxAgeSecs` left behind by earlier sessions.
+// Only names carrying their creation time are touched: the fixed
+// seer_f3d_<index> names older builds used have no reliable age, since hard
+// links share the timestamps of the file they point to.
+int removeStaleAliases(qint64 maxAgeSecs);
 
 }
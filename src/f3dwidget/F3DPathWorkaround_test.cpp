@@ -1,3 +1,4 @@
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -10,11 +11,31 @@ class F3DPathWorkaroundTest : public QObject {
     Q_OBJECT
 
 private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
     void keepsLongStepExtensionWhenNormalizingLoadPath();
     void createsAliasWithLowercaseExtension();
-    void createsAliasUnderSeerAutodelWithoutHiddenAttribute();
+    void createsAliasUnderAliasRootWithoutHiddenAttribute();
+    void createsDistinctAliasesSharingSourceContent();
+    void removesOnlyStaleAliases();
+    void keepsLegacyAliases();
+
+private:
+    // stands in for Seer/autodel, so no test touches the user's aliases
+    QTemporaryDir m_alias_root;
 };
 
+void F3DPathWorkaroundTest::initTestCase()
+{
+    QVERIFY2(m_alias_root.isValid(), "alias root should be created");
+    f3d::workaround::setTempAliasRoot(m_alias_root.path());
+}
+
+void F3DPathWorkaroundTest::cleanupTestCase()
+{
+    f3d::workaround::setTempAliasRoot({});
+}
+
 void F3DPathWorkaroundTest::keepsLongStepExtensionWhenNormalizingLoadPath()
 {
     QTemporaryDir dir;
@@ -49,7 +70,7 @@ void F3DPathWorkaroundTest::createsAliasWithLowercaseExtension()
     QVERIFY(QFile::remove(aliasPath));
 }
 
-void F3DPathWorkaroundTest::createsAliasUnderSeerAutodelWithoutHiddenAttribute()
+void F3DPathWorkaroundTest::createsAliasUnderAliasRootWithoutHiddenAttribute()
 {
     QTemporaryDir dir;
     QVERIFY2(dir.isValid(), "temporary source directory should be created");
@@ -64,8 +85,8 @@ void F3DPathWorkaroundTest::createsAliasUnderSeerAutodelWithoutHiddenAttribute()
     const QString aliasPath = f3d::workaround::createAsciiAlias(sourcePath);
     QVERIFY2(!aliasPath.isEmpty(), "alias path should be created");
 
-    const QString expectedRoot
-        = QDir::cleanPath(f3d::workaround::tempAliasRoot());
+    const QString expectedRoot = QDir::cleanPath(m_alias_root.path());
+    QCOMPARE(QDir::cleanPath(f3d::workaround::tempAliasRoot()), expectedRoot);
     QVERIFY(QDir::cleanPath(aliasPath).startsWith(expectedRoot + "/"));
 
     QVERIFY(QFileInfo(aliasPath).exists());
@@ -73,6 +94,76 @@ void F3DPathWorkaroundTest::createsAliasUnderSeerAutodelWithoutHiddenAttribute()
     QVERIFY(QFile::remove(aliasPath));
 }
 
+void F3DPathWorkaroundTest::createsDistinctAliasesSharingSourceContent()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+
+    const QString sourcePath = dir.filePath("part.stl");
+    QFile source(sourcePath);
+    QVERIFY2(source.open(QIODevice::WriteOnly),
+             "source file should be writable");
+    source.write("solid part");
+    source.close();
+
+    const QString first  = f3d::workaround::createAsciiAlias(sourcePath);
+    const QString second = f3d::workaround::createAsciiAlias(sourcePath);
+    QVERIFY(!first.isEmpty());
+    QVERIFY(!second.isEmpty());
+    QVERIFY(first != second);
+
+    QFile alias(first);
+    QVERIFY(alias.open(QIODevice::ReadOnly));
+    QCOMPARE(alias.readAll(), QByteArray("solid part"));
+    alias.close();
+
+    QVERIFY(QFile::remove(first));
+    QVERIFY(QFile::remove(second));
+    QVERIFY(QFileInfo::exists(sourcePath));
+}
+
+void F3DPathWorkaroundTest::removesOnlyStaleAliases()
+{
+    const QDir root(f3d::workaround::tempAliasRoot());
+    const qint64 old = QDateTime::currentSecsSinceEpoch() - 2 * 24 * 3600;
+    const QString stalePath = root.filePath(
+        QString("seer_f3d_%1_0000000000000000.stl").arg(old, 0, 16));
+    QFile stale(stalePath);
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    stale.close();
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+    const QString sourcePath = dir.filePath("fresh.stl");
+    QFile source(sourcePath);
+    QVERIFY(source.open(QIODevice::WriteOnly));
+    source.close();
+    const QString fresh = f3d::workaround::createAsciiAlias(sourcePath);
+    QVERIFY(!fresh.isEmpty());
+
+    QCOMPARE(f3d::workaround::removeStaleAliases(24 * 3600), 1);
+    QVERIFY(!QFileInfo::exists(stalePath));
+    QVERIFY(QFileInfo::exists(fresh));
+    QVERIFY(QFile::remove(fresh));
+}
+
+void F3DPathWorkaroundTest::keepsLegacyAliases()
+{
+    // fixed names written by builds before the time stamped ones; they may be
+    // hard links sharing a source's old timestamps, so their age is unknown
+    const QDir root(f3d::workaround::tempAliasRoot());
+    const QString legacyPath = root.filePath("seer_f3d_00.stl");
+    QFile legacy(legacyPath);
+    QVERIFY(legacy.open(QIODevice::WriteOnly));
+    QVERIFY(legacy.setFileTime(QDateTime::currentDateTime().addDays(-2),
+                               QFileDevice::FileModificationTime));
+    legacy.close();
+
+    QCOMPARE(f3d::workaround::removeStaleAliases(24 * 3600), 0);
+    QVERIFY(QFileInfo::exists(legacyPath));
+    QVERIFY(QFile::remove(legacyPath));
+}
+
 QTEST_APPLESS_MAIN(F3DPathWorkaroundTest)
 
 #include "F3DPathWorkaround_test.moc"
@@ -0,0 +1,48 @@
+#include "F3DPrefetch.h"
+
+#include <algorithm>
+
+#include <QCollator>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+namespace f3d::prefetch {
+
+QStringList neighbours(const QString &path, const QStringList &suffixes)
+{
+    const QFileInfo info(path);
+    QStringList filters;
+    for (const auto &suffix : suffixes) {
+        filters << "*." + suffix;
+    }
+    QStringList names = info.absoluteDir().entryList(filters, QDir::Files);
+    QCollator collator;
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    std::sort(names.begin(), names.end(), collator);
+
+    QStringList ret;
+    const auto idx = names.indexOf(info.fileName());
+    if (idx < 0) {
+        return ret;
+    }
+    for (const auto i : {idx + 1, idx - 1}) {
+        if (i >= 0 && i < names.size()) {
+            ret << info.absoluteDir().filePath(names[i]);
+        }
+    }
+    return ret;
+}
+
+QString identity(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return {};
+    }
+    return QString("%1:%2").arg(info.size()).arg(
+        info.lastModified().toMSecsSinceEpoch());
+}
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <utility>
+
+#include <QString>
+#include <QStringList>
+
+namespace f3d::prefetch {
+
+// The next and previous files with one of `suffixes` next to `path`, in that
+// order: browsing forward is the common case. Lists the directory, so call
+// it off the GUI thread.
+QStringList neighbours(const QString &path, const QStringList &suffixes);
+
+// Size and mtime of `path`, empty when it does not exist
+QString identity(const QString &path);
+
+// Scenes parsed ahead of time, kept until a preview takes them. `bytes` is
+// what an entry is charged with; once the entries add up to more than the
+// budget the least recently inserted or looked up go first. A file
+// changed on disk since its parse is never handed out. GUI thread only.
+template <typename T>
+class Store {
+public:
+    void setBudget(qint64 bytes)
+    {
+        m_budget = bytes;
+        evict();
+    }
+
+    qint64 usedBytes() const
+    {
+        return m_used;
+    }
+
+    bool contains(const QString &path)
+    {
+        const auto it = find(path);
+        if (it == m_lru.end()) {
+            return false;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it);
+        return true;
+    }
+
+    // False when `value` alone is over the budget and was dropped
+    bool insert(const QString &path, T value, qint64 bytes)
+    {
+        if (bytes > m_budget) {
+            return false;
+        }
+        remove(path);
+        m_lru.push_front({path, identity(path), bytes, std::move(value)});
+        m_used += bytes;
+        evict();
+        return true;
+    }
+
+    std::optional<T> take(const QString &path)
+    {
+        const auto it = find(path);
+        if (it == m_lru.end()) {
+            return std::nullopt;
+        }
+        std::optional<T> ret;
+        if (it->identity == identity(path)) {
+            ret.emplace(std::move(it->value));
+        }
+        m_used -= it->bytes;
+        m_lru.erase(it);
+        return ret;
+    }
+
+private:
+    struct Entry {
+        QString path;
+        QString identity;
+        qint64 bytes = 0;
+        T value;
+    };
+
+    typename std::list<Entry>::iterator find(const QString &path)
+    {
+        for (auto it = m_lru.begin(); it != m_lru.end(); ++it) {
+            if (it->path == path) {
+                return it;
+            }
+        }
+        return m_lru.end();
+    }
+
+    void remove(const QString &path)
+    {
+        const auto it = find(path);
+        if (it != m_lru.end()) {
+            m_used -= it->bytes;
+            m_lru.erase(it);
+        }
+    }
+
+    void evict()
+    {
+        while (m_used > m_budget && !m_lru.empty()) {
+            m_used -= m_lru.back().bytes;
+            m_lru.pop_back();
+        }
+    }
+
+    // most recently used first
+    std::list<Entry> m_lru;
+    qint64 m_used   = 0;
+    qint64 m_budget = 0;
+};
+
+}
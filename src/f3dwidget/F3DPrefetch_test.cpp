@@ -0,0 +1,87 @@
+#include <memory>
+
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "F3DPrefetch.h"
+#include "F3DTestUtil.h"
+
+using f3d::testutil::writeFile;
+
+class F3DPrefetchTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void listsNextThenPreviousInNaturalOrder();
+    void keepsEntriesUnderBudget();
+    void dropsEntriesOfChangedFiles();
+};
+
+void F3DPrefetchTest::listsNextThenPreviousInNaturalOrder()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+    for (const char *name : {"part1.stl", "part2.STL", "part10.stl",
+                             "notes.txt", "part3.obj"}) {
+        QVERIFY(!writeFile(dir, name, "solid").isEmpty());
+    }
+
+    const QStringList suffixes{"stl", "obj"};
+    QCOMPARE(f3d::prefetch::neighbours(dir.filePath("part3.obj"), suffixes),
+             QStringList({dir.filePath("part10.stl"),
+                          dir.filePath("part2.STL")}));
+    QCOMPARE(f3d::prefetch::neighbours(dir.filePath("part1.stl"), suffixes),
+             QStringList({dir.filePath("part2.STL")}));
+    QVERIFY(f3d::prefetch::neighbours(dir.filePath("notes.txt"), suffixes)
+                .isEmpty());
+}
+
+void F3DPrefetchTest::keepsEntriesUnderBudget()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+    const QString a = writeFile(dir, "a.stl", "a");
+    const QString b = writeFile(dir, "b.stl", "b");
+    const QString c = writeFile(dir, "c.stl", "c");
+
+    // move-only values, like the engines the widget keeps
+    f3d::prefetch::Store<std::unique_ptr<int>> store;
+    store.setBudget(100);
+    QVERIFY(!store.insert(a, std::make_unique<int>(0), 101));
+    QVERIFY(store.insert(a, std::make_unique<int>(1), 40));
+    QVERIFY(store.insert(b, std::make_unique<int>(2), 40));
+    // looking `a` up makes `b` the least recently used
+    QVERIFY(store.contains(a));
+    QVERIFY(store.insert(c, std::make_unique<int>(3), 40));
+    QCOMPARE(store.usedBytes(), qint64(80));
+    QVERIFY(!store.contains(b));
+
+    auto taken = store.take(a);
+    QVERIFY(taken.has_value());
+    QCOMPARE(**taken, 1);
+    QVERIFY(!store.take(a).has_value());
+    QCOMPARE(store.usedBytes(), qint64(40));
+
+    store.setBudget(0);
+    QCOMPARE(store.usedBytes(), qint64(0));
+    QVERIFY(!store.contains(c));
+}
+
+void F3DPrefetchTest::dropsEntriesOfChangedFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), "temporary source directory should be created");
+    const QString a = writeFile(dir, "a.stl", "solid a");
+
+    f3d::prefetch::Store<int> store;
+    store.setBudget(100);
+    QVERIFY(store.insert(a, 1, 10));
+    writeFile(dir, "a.stl", "solid ab");
+
+    QVERIFY(!store.take(a).has_value());
+    QCOMPARE(store.usedBytes(), qint64(0));
+}
+
+QTEST_APPLESS_MAIN(F3DPrefetchTest)
+
+#include "F3DPrefetch_test.moc"
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+// Helpers shared by the module tests, header only so each test executable
+// keeps building from its own sources
+namespace f3d::testutil {
+
+// Writes `data` to `name` inside `dir`, returns the path or an empty string
+inline QString writeFile(const QTemporaryDir &dir,
+                         const QString &name,
+                         const QByteArray &data)
+{
+    const QString path = dir.filePath(name);
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return {};
+    }
+    f.write(data);
+    return path;
+}
+
+}
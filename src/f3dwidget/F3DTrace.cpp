@@ -0,0 +1,180 @@
+#include "F3DTrace.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+
+#define qprintt qDebug() << "[F3DViewer]"
+
+namespace f3d::trace {
+namespace {
+
+struct Event {
+    QString name;
+    QString detail;
+    char phase;
+    qint64 ts;
+    qint64 dur;
+    quintptr tid;
+};
+
+struct Session {
+    // 0 while no session is active
+    std::atomic<quint64> id{0};
+    quint64 lastId = 0;
+    std::mutex mutex;
+    QString file;
+    qint64 epoch = 0;
+    std::vector<Event> events;
+};
+
+Session &session()
+{
+    static Session instance;
+    return instance;
+}
+
+// Process wide so a timestamp taken for one session can never be read
+// against the epoch of another
+qint64 nowUs()
+{
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer ret;
+        ret.start();
+        return ret;
+    }();
+    return clock.nsecsElapsed() / 1000;
+}
+
+quint64 activeId()
+{
+    return session().id.load(std::memory_order_relaxed);
+}
+
+void append(quint64 id, Event &&event)
+{
+    auto &s = session();
+    std::lock_guard lock(s.mutex);
+    if (id != 0 && s.id == id) {
+        event.ts -= s.epoch;
+        s.events.push_back(std::move(event));
+    }
+}
+
+}
+
+quint64 start(const QString &file)
+{
+    auto &s = session();
+    std::lock_guard lock(s.mutex);
+    if (s.id != 0) {
+        qprintt << "trace" << s.file << "replaced before it finished";
+    }
+    s.file  = file;
+    s.epoch = nowUs();
+    s.events.clear();
+    s.id = ++s.lastId;
+    return s.id;
+}
+
+bool enabled()
+{
+    return activeId() != 0;
+}
+
+QString finish(quint64 id)
+{
+    auto &s = session();
+    std::vector<Event> events;
+    QString file;
+    {
+        std::lock_guard lock(s.mutex);
+        if (id == 0 || s.id != id) {
+            return {};
+        }
+        s.id   = 0;
+        events = std::move(s.events);
+        file   = s.file;
+        s.events.clear();
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray list;
+    for (const auto &e : events) {
+        QJsonObject obj{
+            {"name", e.name},
+            {"cat", "f3dviewer"},
+            {"ph", QString(QChar(e.phase))},
+            {"ts", e.ts},
+            {"pid", pid},
+            {"tid", qint64(e.tid)},
+        };
+        if (e.phase == 'X') {
+            obj["dur"] = e.dur;
+        }
+        else {
+            obj["s"] = "t";
+        }
+        if (!e.detail.isEmpty()) {
+            obj["args"] = QJsonObject{{"detail", e.detail}};
+        }
+        list.append(obj);
+    }
+
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    QSaveFile out(file);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qprintt << "Error writing trace" << file;
+        return {};
+    }
+    out.write(QJsonDocument(QJsonObject{{"traceEvents", list},
+                                        {"displayTimeUnit", "ms"}})
+                  .toJson(QJsonDocument::Compact));
+    if (!out.commit()) {
+        qprintt << "Error writing trace" << file;
+        return {};
+    }
+    qprintt << "trace written" << file << events.size() << "events";
+    return file;
+}
+
+void mark(const QString &name)
+{
+    const quint64 id = activeId();
+    if (id == 0) {
+        return;
+    }
+    append(id, {name, {}, 'i', nowUs(), 0,
+                quintptr(QThread::currentThreadId())});
+}
+
+Scope::Scope(const char *name, const QString &detail)
+    : m_name(name), m_detail(detail), m_session(activeId())
+{
+    if (m_session != 0) {
+        m_start = nowUs();
+    }
+}
+
+Scope::~Scope()
+{
+    if (m_session == 0 || activeId() != m_session) {
+        return;
+    }
+    append(m_session,
+           {QString::fromLatin1(m_name), m_detail, 'X', m_start,
+            nowUs() - m_start, quintptr(QThread::currentThreadId())});
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+
+// Load phase timeline in the Chrome trace-event format, viewable in
+// chrome://tracing or ui.perfetto.dev. One session per preview: start() arms
+// it, finish() writes the file. Scopes outside a session cost one atomic load.
+namespace f3d::trace {
+
+// Events recorded from now on are written to `file` by finish(). Replaces
+// the active session, if any, and returns the id of the new one.
+quint64 start(const QString &file);
+bool enabled();
+// Writes the collected events and ends session `id` if it is still the
+// active one, returns the file path
+QString finish(quint64 id);
+
+// Instant marker, e.g. "first frame"
+void mark(const QString &name);
+
+// Complete event spanning the lifetime of the object, dropped unless the
+// session active at construction is still active at destruction
+class Scope {
+public:
+    explicit Scope(const char *name, const QString &detail = {});
+    ~Scope();
+    Scope(const Scope &)            = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    QString m_detail;
+    quint64 m_session = 0;
+    qint64 m_start    = -1;
+};
+
+}
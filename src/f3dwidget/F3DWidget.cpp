@@ -2,11 +2,13 @@
 
 #include <f3d/engine.h>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
-#if __has_include(<f3d/log.h>)
-#include <f3d/log.h>
-#define F3DVIEWER_HAS_F3D_LOG 1
-#endif
+#include <map>
+#include <utility>
+#include <variant>
+#include <vector>
 #include <f3d/options.h>
 #include <f3d/scene.h>
 #include <f3d/window.h>
@@ -16,12 +18,26 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QMouseEvent>
+#include <QOffscreenSurface>
 #include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QPainter>
+#include <QPointer>
+#include <QPromise>
 #include <QQuaternion>
+#include <QScopeGuard>
 #include <QVariantAnimation>
 #include <QVector3D>
 
+#include "F3DBootstrap.h"
+#include "F3DFormatSniffer.h"
+#include "F3DInputLog.h"
+#include "F3DLoadPool.h"
+#include "F3DMetrics.h"
 #include "F3DPathWorkaround.h"
+#include "F3DPrefetch.h"
+#include "F3DTrace.h"
 
 #define qprintt qDebug() << "[F3DViewer]"
 
@@ -30,42 +46,29 @@ constexpr auto g_shift_delta   = 0.1f;
 constexpr float g_zoom_factor  = 0.001f;
 constexpr float g_rotate_speed = 0.5f;
 
-#ifdef F3DVIEWER_HAS_F3D_LOG
-void initF3DLogging()
-{
-    static bool initialized = false;
-    if (initialized) {
-        return;
-    }
-    initialized = true;
-
-    f3d::log::setUseColoring(false);
-    f3d::log::forward(
-        [](f3d::log::VerboseLevel level, const std::string &message) {
-            const QString msg = QString::fromStdString(message).trimmed();
-            if (msg.isEmpty()) {
-                return;
-            }
-            switch (level) {
-            case f3d::log::VerboseLevel::DEBUG:
-                // qDebug() << "[F3D] [debug]" << msg;
-                break;
-            case f3d::log::VerboseLevel::INFO:
-                // qInfo() << "[F3D] [info]" << msg;
-                break;
-            case f3d::log::VerboseLevel::WARN:
-                qprintt << "[F3D] [warn]" << msg;
-                break;
-            case f3d::log::VerboseLevel::QUIET:
-                break;
-            default:
-                // case f3d::log::VerboseLevel::ERROR: //compile error
-                qprintt << "[F3D] [error]" << msg;
-            }
-        });
-    f3d::log::setVerboseLevel(f3d::log::VerboseLevel::QUIET, true);
-}
-#endif
+constexpr auto g_viewer_option_prefix  = "viewer.";
+constexpr auto g_fallback_default      = "default";
+constexpr auto g_fallback_step         = "STEP";
+constexpr auto g_fallback_alias        = "alias";
+constexpr auto g_arg_continuous_render = "viewer.render.continuous";
+constexpr auto g_arg_interactive_scale = "viewer.interactive.scale";
+constexpr auto g_arg_interactive_idle  = "viewer.interactive.idle_ms";
+constexpr auto g_arg_interactive_min   = "viewer.interactive.min_frame_ms";
+constexpr auto g_arg_interactive_pass  = "viewer.interactive.passes";
+// A parsed scene is charged at least this many times its file size: the
+// resident set delta of a parse also moves with other threads and reused
+// allocations, and can read as nothing
+constexpr qint64 g_prefetch_min_expansion = 2;
+// files shown last, not prefetched again right after their engine went
+constexpr int g_prefetch_recent = 8;
+
+// Sidebar effects that dominate frame time on heavy scenes
+constexpr const char *g_interactive_passes[] = {
+    "render.effect.ambient_occlusion",
+    "render.effect.translucency_support",
+    "render.effect.anti_aliasing",
+    "render.background.blur.enable",
+};
 
 std::filesystem::path toFsPath(const QString &path)
 {
@@ -94,24 +97,44 @@ bool isStepFile(const QString &path)
     return suffix == "step" || suffix == "stp";
 }
 
+std::unique_ptr<f3d::engine> createEngine()
+{
+    f3d::trace::Scope trace("createExternal");
+    // the engine can be parsed before its widget exists and outlive it when
+    // a load is abandoned, so resolve against whichever context is current
+    // at the call
+    auto ret = std::make_unique<f3d::engine>(
+        f3d::engine::createExternal([](const char *name) {
+            auto *ctx = QOpenGLContext::currentContext();
+            return ctx ? ctx->getProcAddress(name) : nullptr;
+        }));
+    f3d::bootstrap::applyDefaultOptions(*ret);
+    return ret;
+}
+
 }  // namespace
 
 F3DWidget::F3DWidget(QWidget *parent) : QOpenGLWidget(parent)
 {
     qprintt << this;
     setFocusPolicy(Qt::StrongFocus);
-    connect(&m_animation.timer, &QTimer::timeout, this, &F3DWidget::onAnimTick);
-#ifdef F3DVIEWER_HAS_F3D_LOG
-    initF3DLogging();
-#endif
-    qprintt << "f3d version" << f3d::engine::getLibInfo().VersionFull;
+    connect(&m_load_watcher, &QFutureWatcher<LoadResult>::finished, this,
+            &F3DWidget::onLoadFinished);
+    m_interactive.idle.setSingleShot(true);
+    connect(&m_interactive.idle, &QTimer::timeout, this,
+            &F3DWidget::endInteraction);
 }
 
 F3DWidget::~F3DWidget()
 {
-    makeCurrent();
-    m_engine.reset();
-    doneCurrent();
+    m_load_watcher.disconnect(this);
+    abandonLoad();
+    if (m_engine || m_interactive.fbo) {
+        makeCurrent();
+        m_interactive.fbo.reset();
+        m_engine.reset();
+        doneCurrent();
+    }
     if (!m_load_alias_path.isEmpty()) {
         QFile::remove(m_load_alias_path);
     }
@@ -120,12 +143,39 @@ F3DWidget::~F3DWidget()
 
 bool F3DWidget::load(const QString &path)
 {
+    f3d::trace::Scope trace("normalizeLoadPath");
     m_original_path = QFileInfo(path).absoluteFilePath();
     m_path          = f3d::workaround::normalizeLoadPath(m_original_path);
     m_forced_reader.reset();
     return true;
 }
 
+const F3DWidget::LoadInfo &F3DWidget::loadInfo() const
+{
+    return m_load_info;
+}
+
+bool F3DWidget::isLoading() const
+{
+    return m_loading;
+}
+
+void F3DWidget::startInputRecording(const QString &file)
+{
+    m_input_recorder = std::make_unique<f3d::input::Recorder>(
+        file, size(), m_original_path);
+}
+
+bool F3DWidget::event(QEvent *event)
+{
+    // resizes during a load still decide the size the replay runs at
+    if (m_input_recorder
+        && (isEngineReady() || event->type() == QEvent::Resize)) {
+        m_input_recorder->record(event);
+    }
+    return QOpenGLWidget::event(event);
+}
+
 void F3DWidget::initializeGL()
 {
     QOpenGLWidget::initializeGL();
@@ -135,42 +185,62 @@ void F3DWidget::initializeGL()
     }
 
     try {
-        qprintt << "f3d version" << f3d::engine::getLibInfo().VersionFull;
-        f3d::engine::autoloadPlugins();
-        m_engine = std::make_unique<f3d::engine>(
-            f3d::engine::createExternal([this](const char *name) {
-                return context()->getProcAddress(name);
-            }));
-        auto &opt     = m_engine->getOptions();
-        auto setUiOpt = [&opt](const char *key, const char *value) {
-            try {
-                opt.setAsString(key, value);
+        QElapsedTimer et;
+        et.start();
+        f3d::bootstrap::init();
+        const auto bootstrapMs = et.restart();
+
+        auto &st = prefetchState();
+        st.recent.removeAll(m_original_path);
+        st.recent.prepend(m_original_path);
+        while (st.recent.size() > g_prefetch_recent) {
+            st.recent.removeLast();
+        }
+        auto prefetched = st.store.take(m_original_path);
+        // a prefetch parse of this file still running is waited for, its
+        // engine comes through onPrefetched() instead of a load
+        const bool waiting = !prefetched && waitForPrefetch();
+        if (!waiting) {
+            m_engine = prefetched ? std::move(prefetched->engine)
+                                  : createEngine();
+            syncWindowSize();
+        }
+        qprintt << "engine ready, bootstrap" << bootstrapMs << "ms, engine"
+                << et.elapsed() << "ms, prefetched" << bool(prefetched)
+                << "waiting" << waiting;
+
+        if (prefetched) {
+            // parsed ahead of time, finished once the widget is set up so
+            // the viewer sees the same signals as for a load
+            m_loading           = true;
+            auto ret            = std::move(prefetched->result);
+            ret.info.prefetched = true;
+            m_load_alias_path   = ret.aliasPath;
+            QMetaObject::invokeMethod(
+                this, [this, ret]() { finishLoad(ret); },
+                Qt::QueuedConnection);
+        }
+        else if (!waiting) {
+            // Load model in background thread
+            loadModelInBackground();
+        }
+
+        // Frames are requested with update() when something changes; the
+        // continuous mode re-renders back to back for profiling only. A
+        // playing animation chains frames the same way, paced by the swap.
+        connect(this, &QOpenGLWidget::frameSwapped, this, [this]() {
+            if (m_paint_ms >= 0) {
+                const double interval
+                    = m_swap_clock.isValid()
+                          ? m_swap_clock.nsecsElapsed() / 1e6
+                          : -1.;
+                m_frame_stats.record(m_paint_ms, interval);
+                m_swap_clock.start();
             }
-            catch (...) {
+            if (m_continuous_render || isAnimationRunning()) {
+                update();
             }
-        };
-        opt.render.grid.enable  = true;
-        opt.ui.axis             = true;
-        opt.model.color.opacity = 1.0;
-        setUiOpt("scene.animation.indices", "-1");
-        setUiOpt("ui.drop_zone.enable", "0");
-        setUiOpt("ui.drop_zone.show_logo", "0");
-        setUiOpt("ui.notifications.enable", "0");
-        setUiOpt("ui.notifications.show_bindings", "0");
-        setUiOpt("ui.cheatsheet", "0");
-        setUiOpt("ui.console", "0");
-        setUiOpt("ui.minimal_console", "0");
-        setUiOpt("ui.filename", "0");
-        setUiOpt("ui.animation_progress", "0");
-        setUiOpt("ui.loader_progress", "0");
-
-        m_engine->getWindow().setSize(width(), height());
-
-        // Load model in background thread
-        loadModelInBackground();
-
-        connect(this, &QOpenGLWidget::frameSwapped, this,
-                [this]() { update(); });
+        });
     }
     catch (const std::exception &e) {
         qprintt << "Error initializing F3D engine:" << e.what();
@@ -182,126 +252,486 @@ void F3DWidget::initializeGL()
 
 void F3DWidget::loadModelInBackground()
 {
-    if (m_loading) {
+    if (m_loading || !m_engine) {
         return;
     }
+    // full quality options and size before the worker takes the engine
+    endInteraction();
     m_loading = true;
 
-    QTimer::singleShot(0, this, [this]() {
-        try {
-            if (!addSceneContent()) {
-                m_loading = false;
-                return;
+    // The worker owns the engine until onLoadFinished(); paintGL() only draws
+    // a placeholder and option writes are queued in the meantime.
+    m_load_job = std::make_shared<LoadJob>();
+    LoadRequest req{m_load_job,        m_original_path, m_path,
+                    m_load_alias_path, m_forced_reader, m_reader_cache};
+    f3d::engine *engine = m_engine.get();
+    auto parse = [engine, req]() {
+        QElapsedTimer et;
+        et.start();
+        LoadResult ret   = parseScene(engine, req);
+        ret.info.parseMs = et.elapsed();
+        std::lock_guard lock(req.job->mutex);
+        req.job->done = true;
+        if (req.job->orphan) {
+            if (ret.aliasPath != req.aliasPath && !ret.aliasPath.isEmpty()) {
+                QFile::remove(ret.aliasPath);
             }
+            // GL objects and the offscreen surface belong to the GUI thread
+            QMetaObject::invokeMethod(
+                qApp, [job = req.job]() { releaseOrphan(*job); },
+                Qt::QueuedConnection);
+        }
+        return ret;
+    };
+    // an abandoned parse keeps its thread, so loads never share the pool
+    // the thumbnails and metrics use. A promise instead of QtConcurrent::run
+    // lets abandonLoad() drop the job while it is still queued.
+    auto promise = std::make_shared<QPromise<LoadResult>>();
+    m_load_watcher.setFuture(promise->future());
+    m_load_job->ticket = f3d::loadpool::start([promise, parse]() {
+        promise->start();
+        promise->addResult(parse());
+        promise->finish();
+    });
+    update();
+}
 
-            m_loading = false;
-            emit sigLoaded();
-            emit sigAnimationStateChanged(m_animation.playing);
-            emit sigAnimationProgressChanged(m_animation.pos,
-                                             getAnimationDuration());
-            update();
+void F3DWidget::abandonLoad()
+{
+    if (!m_load_job) {
+        return;
+    }
+    m_load_job->cancelled = true;
+    // queued behind other parses: it never runs and the engine, which holds
+    // no scene yet, is released with the widget
+    if (f3d::loadpool::drop(*m_load_job->ticket)) {
+        qprintt << "dropping queued load of" << m_original_path;
+        m_load_job.reset();
+        return;
+    }
+    {
+        std::lock_guard lock(m_load_job->mutex);
+        // scene.add() cannot be interrupted, and waiting for it here would
+        // block the GUI thread for the whole parse
+        if (!m_load_job->done) {
+            qprintt << "abandoning load of" << m_original_path;
+            // its thread no longer holds up the next preview's load
+            f3d::loadpool::abandon(*m_load_job->ticket);
+            m_load_job->orphan = std::move(m_engine);
+            if (auto *shared = context()) {
+                auto &job   = *m_load_job;
+                job.surface = std::make_unique<QOffscreenSurface>();
+                job.surface->setFormat(shared->format());
+                job.surface->create();
+                job.context = std::make_unique<QOpenGLContext>();
+                job.context->setFormat(shared->format());
+                job.context->setShareContext(shared);
+                job.context->create();
+            }
         }
-        catch (const std::exception &e) {
-            qprintt << "Error loading model:" << e.what() << "path:" << m_path;
-            if (isStepFile(m_original_path)) {
-                try {
-                    m_engine->getScene().clear();
-                    m_forced_reader = "STEP";
-                    if (!addSceneContent()) {
-                        m_loading = false;
-                        return;
-                    }
-
-                    m_loading = false;
-                    emit sigLoaded();
-                    emit sigAnimationStateChanged(m_animation.playing);
-                    emit sigAnimationProgressChanged(m_animation.pos,
-                                                     getAnimationDuration());
-                    update();
-                    return;
-                }
-                catch (const std::exception &retry) {
-                    qprintt << "Retry loading STEP with forced reader failed:"
-                            << retry.what() << "path:" << m_path;
-                }
-                catch (...) {
-                    qprintt << "Retry loading STEP with forced reader failed"
-                            << "path:" << m_path;
-                }
+    }
+    m_load_job.reset();
+}
+
+void F3DWidget::releaseOrphan(LoadJob &job)
+{
+    std::unique_lock lock(job.mutex);
+    auto surface = std::move(job.surface);
+    auto context = std::move(job.context);
+    auto engine  = std::move(job.orphan);
+    lock.unlock();
+    const bool current
+        = context && surface && context->makeCurrent(surface.get());
+    engine.reset();
+    if (current) {
+        context->doneCurrent();
+    }
+}
+
+struct F3DWidget::PrefetchState {
+    f3d::prefetch::Store<Prefetched> store;
+    // engines being parsed, by original path
+    struct Pending {
+        std::shared_ptr<LoadJob> job;
+        std::unique_ptr<f3d::engine> engine;
+        // a preview of the file opened while it was parsing
+        QPointer<F3DWidget> waiter;
+    };
+    std::map<QString, Pending> pending;
+    // original paths of the last previews, most recent first
+    QStringList recent;
+};
+
+F3DWidget::Prefetched::~Prefetched()
+{
+    if (!result.aliasPath.isEmpty()) {
+        QFile::remove(result.aliasPath);
+    }
+}
+
+F3DWidget::PrefetchState &F3DWidget::prefetchState()
+{
+    // Never destroyed, like the load pool: a parse may still be running
+    static auto *instance = new PrefetchState;
+    return *instance;
+}
+
+void F3DWidget::prefetch(const QStringList &paths,
+                         const QString &readerCache,
+                         qint64 budgetBytes)
+{
+    auto &st = prefetchState();
+    st.store.setBudget(budgetBytes);
+    // the user moved on: queued parses of other files are dropped, a running
+    // one cannot be interrupted and still lands in the store
+    for (auto it = st.pending.begin(); it != st.pending.end();) {
+        if (!paths.contains(it->first)
+            && f3d::loadpool::drop(*it->second.job->ticket)) {
+            it = st.pending.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    if (budgetBytes <= 0) {
+        return;
+    }
+    f3d::bootstrap::init();
+    for (const auto &path : paths) {
+        const qint64 minBytes
+            = QFileInfo(path).size() * g_prefetch_min_expansion;
+        // the file just left is one step back, its engine is already gone
+        if (st.pending.count(path) || st.store.contains(path)
+            || st.recent.contains(path) || minBytes > budgetBytes) {
+            continue;
+        }
+        auto job = std::make_shared<LoadJob>();
+        LoadRequest req;
+        req.job          = job;
+        req.originalPath = path;
+        req.path         = f3d::workaround::normalizeLoadPath(path);
+        req.readerCache  = readerCache;
+        auto engine         = createEngine();
+        f3d::engine *parsed = engine.get();
+        auto parse          = [parsed, req, minBytes]() {
+            f3d::trace::Scope trace("prefetch", req.originalPath);
+            // Every plugin is loaded before the first speculative parse, so
+            // the registry is frozen and the parse holds no lock a live load
+            // could wait on. Only that one-time plugin load can delay one.
+            f3d::bootstrap::ensureAllPlugins();
+            const qint64 before = f3d::metrics::currentRss();
+            QElapsedTimer et;
+            et.start();
+            LoadResult ret   = parseScene(parsed, req);
+            ret.info.parseMs = et.elapsed();
+            // what stays resident is what the budget is about, the peak
+            // during the parse is not
+            const qint64 bytes
+                = qMax(minBytes, f3d::metrics::currentRss() - before);
+            QMetaObject::invokeMethod(
+                qApp,
+                [path = req.originalPath, ret, bytes]() {
+                    onPrefetched(path, ret, bytes);
+                },
+                Qt::QueuedConnection);
+        };
+        job->ticket = f3d::loadpool::start(parse, f3d::loadpool::background());
+        st.pending[path] = {job, std::move(engine)};
+    }
+}
+
+void F3DWidget::onPrefetched(const QString &path,
+                             const LoadResult &ret,
+                             qint64 bytes)
+{
+    auto &st      = prefetchState();
+    const auto it = st.pending.find(path);
+    if (it == st.pending.end()) {
+        return;
+    }
+    const QPointer<F3DWidget> waiter = it->second.waiter;
+    Prefetched item;
+    item.engine = std::move(it->second.engine);
+    item.result = ret;
+    st.pending.erase(it);
+    if (waiter) {
+        waiter->adoptPrefetched(std::move(item));
+        return;
+    }
+    if (!ret.ok) {
+        return;
+    }
+    if (st.store.insert(path, std::move(item), bytes)) {
+        qprintt << "prefetched" << path << bytes / (1024 * 1024) << "MB, kept"
+                << st.store.usedBytes() / (1024 * 1024) << "MB";
+    }
+}
+
+bool F3DWidget::waitForPrefetch()
+{
+    auto &st      = prefetchState();
+    const auto it = st.pending.find(m_original_path);
+    if (it == st.pending.end()) {
+        return false;
+    }
+    // not started yet: the load pool runs it sooner than the low priority
+    // thread would
+    if (f3d::loadpool::drop(*it->second.job->ticket)) {
+        st.pending.erase(it);
+        return false;
+    }
+    it->second.waiter = this;
+    m_loading         = true;
+    return true;
+}
+
+void F3DWidget::adoptPrefetched(Prefetched item)
+{
+    m_engine            = std::move(item.engine);
+    auto ret            = std::move(item.result);
+    ret.info.prefetched = true;
+    finishLoad(ret);
+}
+
+F3DWidget::LoadResult F3DWidget::parseScene(f3d::engine *engine,
+                                            LoadRequest req)
+{
+    f3d::trace::Scope trace("parseScene");
+    LoadResult ret;
+    ret.path         = req.path;
+    ret.aliasPath    = req.aliasPath;
+    ret.forcedReader = req.forcedReader;
+
+    auto cancelled = [&req, &ret]() {
+        ret.cancelled = req.job->cancelled;
+        return ret.cancelled;
+    };
+    auto &scene   = engine->getScene();
+    auto supports = [&scene](const QString &path) {
+        const auto readers = f3d::bootstrap::readersLock();
+        return scene.supports(toFsPath(path));
+    };
+    auto tryAdd = [engine, &scene, &supports, &ret](const char *attempt) {
+        f3d::trace::Scope trace("scene.add", attempt);
+        ++ret.info.attempts;
+        // plugins are loaded lazily, pull in the rest only when needed
+        if (ret.forcedReader) {
+            f3d::bootstrap::ensurePluginForReader(*ret.forcedReader);
+        }
+        else if (!supports(ret.path)) {
+            f3d::bootstrap::ensureAllPlugins();
+        }
+        engine->getOptions().scene.force_reader = ret.forcedReader;
+        // sampled even when the reader throws, failed parses peak too
+        const auto sampleRss = qScopeGuard([&ret]() {
+            ret.info.rssPeak
+                = qMax(ret.info.rssPeak, f3d::metrics::currentRss());
+        });
+        const auto readers = f3d::bootstrap::readersLock();
+        scene.add(toFsPath(ret.path));
+        ret.ok = true;
+    };
+
+    if (cancelled()) {
+        return ret;
+    }
+    // Let the content pick the reader, and skip attempts that are known to
+    // fail for files like this one instead of paying a full parse for them.
+    f3d::bootstrap::ensurePluginFor(req.originalPath);
+    std::optional<f3d::trace::Scope> sniffTrace(std::in_place, "sniff");
+    const auto format = f3d::sniff::detect(req.originalPath);
+    if (!ret.forcedReader && format.reader) {
+        ret.forcedReader = format.reader;
+    }
+    ret.info.format = format.kind;
+    const QString fallback
+        = f3d::sniff::knownFallback(req.readerCache, req.originalPath, format);
+    sniffTrace.reset();
+
+    const QString loadPath   = ret.path;
+    const auto sniffedReader = ret.forcedReader;
+    const bool stepApplies
+        = isStepFile(req.originalPath) && sniffedReader != "STEP";
+    const bool aliasApplies = ret.aliasPath.isEmpty()
+                              && shouldRetryWithAsciiAlias(req.originalPath);
+    auto dropAlias = [&req, &ret]() {
+        if (ret.aliasPath != req.aliasPath) {
+            QFile::remove(ret.aliasPath);
+            ret.aliasPath = req.aliasPath;
+        }
+    };
+    // Sets up the named attempt and runs it, false when it does not apply
+    // to this file or fails
+    auto attempt = [&](const char *name) {
+        if (cancelled()) {
+            return false;
+        }
+        if (ret.info.attempts > 0) {
+            scene.clear();
+        }
+        ret.path         = loadPath;
+        ret.forcedReader = sniffedReader;
+        if (QLatin1String(name) == QLatin1String(g_fallback_step)) {
+            if (!stepApplies) {
+                return false;
             }
-            if (m_load_alias_path.isEmpty()
-                && shouldRetryWithAsciiAlias(m_original_path)) {
-                m_load_alias_path
-                    = f3d::workaround::createAsciiAlias(m_original_path);
-                if (!m_load_alias_path.isEmpty()) {
-                    try {
-                        m_path
-                            = f3d::workaround::normalizeLoadPath(m_load_alias_path);
-                        qprintt << "Retry loading via alias:" << m_path;
-                        if (!addSceneContent()) {
-                            m_loading = false;
-                            return;
-                        }
-
-                        m_loading = false;
-                        emit sigLoaded();
-                        emit sigAnimationStateChanged(m_animation.playing);
-                        emit sigAnimationProgressChanged(
-                            m_animation.pos, getAnimationDuration());
-                        update();
-                        return;
-                    }
-                    catch (const std::exception &retry) {
-                        qprintt << "Retry loading model failed:" << retry.what()
-                                << "alias:" << m_path;
-                    }
-                    catch (...) {
-                        qprintt << "Retry loading model failed"
-                                << "alias:" << m_path;
-                    }
-                }
+            dropAlias();
+            ret.forcedReader = "STEP";
+        }
+        else if (QLatin1String(name) == QLatin1String(g_fallback_alias)) {
+            if (!aliasApplies) {
+                return false;
+            }
+            if (ret.aliasPath.isEmpty()) {
+                f3d::trace::Scope trace("createAsciiAlias");
+                ret.aliasPath
+                    = f3d::workaround::createAsciiAlias(req.originalPath);
             }
-            m_forced_reader.reset();
-            m_loading = false;
+            if (ret.aliasPath.isEmpty()) {
+                return false;
+            }
+            ret.path = f3d::workaround::normalizeLoadPath(ret.aliasPath);
+            qprintt << "Retry loading via alias:" << ret.path;
+        }
+        else {
+            dropAlias();
+        }
+        try {
+            tryAdd(name);
+            return true;
+        }
+        catch (const std::exception &e) {
+            qprintt << "Loading with" << name << "failed:" << e.what()
+                    << "path:" << ret.path;
         }
         catch (...) {
-            qprintt << "Error loading model";
-            m_loading = false;
+            qprintt << "Loading with" << name << "failed"
+                    << "path:" << ret.path;
         }
-    });
+        return false;
+    };
+
+    // A remembered hint only reorders the attempts: when it does not apply
+    // to this file or fails, the default and the other retries still run.
+    std::vector<const char *> attempts;
+    for (const char *name : {g_fallback_step, g_fallback_alias}) {
+        if (fallback == QLatin1String(name)) {
+            qprintt << "default load known to fail, trying" << name
+                    << "path:" << loadPath;
+            attempts.push_back(name);
+        }
+    }
+    for (const char *name : {g_fallback_default, g_fallback_step,
+                             g_fallback_alias}) {
+        if (fallback != QLatin1String(name)) {
+            attempts.push_back(name);
+        }
+    }
+    for (const char *name : attempts) {
+        if (attempt(name)) {
+            const QString hint
+                = QLatin1String(name) == QLatin1String(g_fallback_default)
+                      ? QString()
+                      : QString(name);
+            if (hint != fallback) {
+                f3d::sniff::rememberFallback(req.readerCache, req.originalPath,
+                                             format, hint);
+            }
+            return ret;
+        }
+    }
+
+    dropAlias();
+    if (!fallback.isEmpty()) {
+        // stale hint, let the next load try the default reader again
+        f3d::sniff::rememberFallback(req.readerCache, req.originalPath, format,
+                                     {});
+    }
+    ret.path = loadPath;
+    ret.forcedReader.reset();
+    return ret;
 }
 
-bool F3DWidget::addSceneContent()
+void F3DWidget::onLoadFinished()
 {
+    finishLoad(m_load_watcher.result());
+}
+
+void F3DWidget::finishLoad(const LoadResult &ret)
+{
+    f3d::trace::Scope trace("onLoadFinished");
+    m_load_job.reset();
+    m_placeholder = {};
+    if (ret.cancelled) {
+        m_loading = false;
+        return;
+    }
+    m_path            = ret.path;
+    m_load_alias_path = ret.aliasPath;
+    m_forced_reader   = ret.forcedReader;
+    m_loading         = false;
+    m_load_info       = ret.info;
+    m_load_info.alias = !ret.aliasPath.isEmpty();
+    m_load_info.reader
+        = QString::fromStdString(ret.forcedReader.value_or(std::string()));
     if (!m_engine) {
-        return false;
+        return;
+    }
+
+    syncWindowSize();
+    const auto pending = std::exchange(m_pending_options, {});
+    for (const auto &[key, value] : pending) {
+        setOption(key, value);
+    }
+    if (!ret.ok) {
+        emit sigLoadFailed();
+        update();
+        return;
     }
 
+    try {
+        onSceneAdded();
+    }
+    catch (const std::exception &e) {
+        qprintt << "Error preparing scene:" << e.what();
+    }
+    catch (...) {
+        qprintt << "Error preparing scene";
+    }
+    emit sigLoaded();
+    emit sigAnimationStateChanged(m_animation.playing);
+    emit sigAnimationProgressChanged(m_animation.pos, getAnimationDuration());
+    update();
+}
+
+void F3DWidget::onSceneAdded()
+{
     auto &scene = m_engine->getScene();
-    m_engine->getOptions().scene.force_reader = m_forced_reader;
-    scene.add(toFsPath(m_path));
     setupDefaultCamera();
 
-    m_animation.timer.stop();
-    m_animation.pos       = 0.0;
-    const double duration = scene.animationTimeRange().second;
-    if (duration > 0.0) {
-        m_animation.timer.setInterval(16);
-        if (m_animation.playing) {
-            m_animation.timer.start();
-            m_animation.elapsed.start();
-        }
+    m_animation.pos      = 0.0;
+    m_animation.seek     = false;
+    m_animation.duration = std::max(0.0, scene.animationTimeRange().second);
+    if (m_animation.duration > 0.0) {
+        m_animation.elapsed.start();
         scene.loadAnimationTime(m_animation.pos);
     }
     else {
         m_animation.playing = false;
     }
-    return true;
 }
 
 void F3DWidget::setupDefaultCamera()
 {
+    f3d::trace::Scope trace("setupDefaultCamera");
     auto &cam = m_engine->getWindow().getCamera();
+    // start from the front view of the current up axis, resetToBounds keeps
+    // the direction and only fits the distance
+    const QVector3D direction = cameraDirection(CP_Front);
+    const QVector3D up        = cameraUpVector(CP_Front);
+    cam.setFocalPoint({0, 0, 0});
+    cam.setPosition({-direction.x(), -direction.y(), -direction.z()});
+    cam.setViewUp({up.x(), up.y(), up.z()});
     cam.resetToBounds(0.7);
     cam.azimuth(45);
     cam.elevation(isYUp() ? 30 : 15);
@@ -370,18 +800,175 @@ QVector3D F3DWidget::cameraUpVector(CameraPos cp) const
 
 void F3DWidget::resizeGL(int w, int h)
 {
-    if (m_engine) {
-        m_engine->getWindow().setSize(w, h);
+    // w and h are logical pixels, the window needs the framebuffer size
+    Q_UNUSED(w);
+    Q_UNUSED(h);
+    if (isEngineReady()) {
+        syncWindowSize();
     }
 }
 
 void F3DWidget::paintGL()
 {
+    f3d::trace::Scope trace("paintGL");
+    m_paint_ms = -1;
+    if (m_loading) {
+        paintPlaceholder();
+        return;
+    }
     if (m_engine) {
-        m_engine->getWindow().render();
+        QElapsedTimer et;
+        et.start();
+        applyPendingInput();
+        advanceAnimation();
+        loadPose();
+        renderScene();
+        m_paint_ms = et.nsecsElapsed() / 1e6;
+    }
+}
+
+QSize F3DWidget::deviceSize() const
+{
+    return size() * devicePixelRatio();
+}
+
+void F3DWidget::syncWindowSize()
+{
+    const QSize px = deviceSize();
+    m_engine->getWindow().setSize(px.width(), px.height());
+}
+
+void F3DWidget::renderScene()
+{
+    auto &window = m_engine->getWindow();
+    if (!m_interactive.active || m_interactive.scale >= 1.0) {
+        QElapsedTimer et;
+        et.start();
+        window.render();
+        if (!m_interactive.active) {
+            m_interactive.lastFrame = et.elapsed();
+        }
+        return;
+    }
+
+    // Render into a smaller offscreen target, then stretch it over the
+    // framebuffer a full quality frame would cover
+    auto *gl = context()->functions();
+    const QRect target(QPoint(), deviceSize());
+    const QSize size(qMax(1, qRound(target.width() * m_interactive.scale)),
+                     qMax(1, qRound(target.height() * m_interactive.scale)));
+    if (!m_interactive.fbo || m_interactive.fbo->size() != size) {
+        m_interactive.fbo = std::make_unique<QOpenGLFramebufferObject>(
+            size, QOpenGLFramebufferObject::CombinedDepthStencil);
+    }
+    m_interactive.fbo->bind();
+    gl->glViewport(0, 0, size.width(), size.height());
+    window.setSize(size.width(), size.height());
+    window.render();
+    m_interactive.fbo->release();
+    gl->glViewport(target.x(), target.y(), target.width(), target.height());
+    QOpenGLFramebufferObject::blitFramebuffer(
+        nullptr, target, m_interactive.fbo.get(), QRect(QPoint(), size),
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+}
+
+void F3DWidget::beginInteraction()
+{
+    if (!isEngineReady()) {
+        return;
+    }
+    if (m_interactive.active) {
+        m_interactive.idle.start(m_interactive.idleMs);
+        return;
+    }
+    // light scenes already render fast enough at full quality
+    if (m_interactive.lastFrame < m_interactive.minFrameMs) {
+        return;
+    }
+    m_interactive.active = true;
+    m_interactive.idle.start(m_interactive.idleMs);
+    if (!m_interactive.dropPasses) {
+        return;
+    }
+    auto &opt = m_engine->getOptions();
+    for (const char *key : g_interactive_passes) {
+        try {
+            const auto value = opt.get(key);
+            if (std::holds_alternative<bool>(value) && std::get<bool>(value)) {
+                opt.setAsString(key, "false");
+                m_interactive.disabled << key;
+            }
+        }
+        catch (...) {
+            qprintt << "Error reading option" << key;
+        }
     }
 }
 
+void F3DWidget::endInteraction()
+{
+    m_interactive.idle.stop();
+    if (!m_interactive.active) {
+        return;
+    }
+    m_interactive.active = false;
+    const auto disabled  = std::exchange(m_interactive.disabled, {});
+    if (!m_engine) {
+        return;
+    }
+    // the worker owns the engine, onLoadFinished() applies these
+    if (m_loading) {
+        for (const auto &key : disabled) {
+            m_pending_options.append({key, "true"});
+        }
+        return;
+    }
+    for (const auto &key : disabled) {
+        try {
+            m_engine->getOptions().setAsString(key.toStdString(), "true");
+        }
+        catch (...) {
+            qprintt << "Error restoring option" << key;
+        }
+    }
+    syncWindowSize();
+    update();
+}
+
+void F3DWidget::setReaderCache(const QString &iniPath)
+{
+    m_reader_cache = iniPath;
+}
+
+void F3DWidget::setPlaceholder(const QImage &frame)
+{
+    m_placeholder = frame;
+    if (m_loading) {
+        update();
+    }
+}
+
+void F3DWidget::paintPlaceholder()
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette().color(QPalette::Window));
+    if (!m_placeholder.isNull()) {
+        QRect target(QPoint(),
+                     m_placeholder.size().scaled(size(), Qt::KeepAspectRatio));
+        target.moveCenter(rect().center());
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        p.drawImage(target, m_placeholder);
+        return;
+    }
+    p.setPen(palette().color(QPalette::PlaceholderText));
+    p.drawText(rect(), Qt::AlignCenter, tr("Loading..."));
+}
+
+bool F3DWidget::isEngineReady() const
+{
+    return m_engine && !m_loading;
+}
+
 void F3DWidget::mousePressEvent(QMouseEvent *event)
 {
     m_pos = event->pos();
@@ -394,66 +981,92 @@ void F3DWidget::mouseReleaseEvent(QMouseEvent *event)
 
 void F3DWidget::mouseMoveEvent(QMouseEvent *event)
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return;
     }
 
     auto delta = event->position() - m_pos;
     m_pos      = event->position();
-    auto &cam  = m_engine->getWindow().getCamera();
-
-    auto panCamera = [this, &cam](float dx, float dy, double speedScale = 1.0) {
-        auto pos         = cam.getPosition();
-        auto focal       = cam.getFocalPoint();
-        double dist      = std::sqrt(std::pow(focal[0] - pos[0], 2)
-                                     + std::pow(focal[1] - pos[1], 2)
-                                     + std::pow(focal[2] - pos[2], 2));
-        double pan_speed = dist * 0.001 * speedScale;
-        cam.pan(-dx * pan_speed, dy * pan_speed);
-    };
 
+    // Only queue here, paintGL() replays the steps once per frame
+    InputStep step;
     if (event->buttons() & Qt::LeftButton) {
         if (event->modifiers() == Qt::NoModifier) {
-            cam.azimuth(-delta.x() * g_rotate_speed);
-            cam.elevation(delta.y() * g_rotate_speed);
+            step.azimuth   = -delta.x() * g_rotate_speed;
+            step.elevation = delta.y() * g_rotate_speed;
         }
         else if (event->modifiers() & Qt::ShiftModifier) {
-            cam.azimuth(-delta.x() * g_rotate_speed * g_shift_delta);
-            cam.elevation(delta.y() * g_rotate_speed * g_shift_delta);
+            step.azimuth   = -delta.x() * g_rotate_speed * g_shift_delta;
+            step.elevation = delta.y() * g_rotate_speed * g_shift_delta;
         }
         else if (event->modifiers() & Qt::ControlModifier) {
+            step.roll = -delta.x() * g_rotate_speed;
+        }
+        else {
+            return;
+        }
+    }
+    else if (event->buttons() & Qt::RightButton) {
+        step.pan = delta
+                   * (event->modifiers() & Qt::ShiftModifier ? g_shift_delta
+                                                             : 1.);
+    }
+    else {
+        return;
+    }
+    m_pending_input.push_back(step);
+    beginInteraction();
+    update();
+}
+
+void F3DWidget::applyPendingInput()
+{
+    const auto steps = std::exchange(m_pending_input, {});
+    auto &cam        = m_engine->getWindow().getCamera();
+    for (const auto &in : steps) {
+        if (in.azimuth != 0. || in.elevation != 0.) {
+            cam.azimuth(in.azimuth);
+            cam.elevation(in.elevation);
+        }
+        if (in.roll != 0.) {
             auto pos_arr = cam.getPosition();
             QVector3D pos(pos_arr[0], pos_arr[1], pos_arr[2]);
             auto focal_arr = cam.getFocalPoint();
             QVector3D focal(focal_arr[0], focal_arr[1], focal_arr[2]);
             auto rollRot = QQuaternion::fromAxisAndAngle(
-                (focal - pos).normalized(), -delta.x() * g_rotate_speed);
+                (focal - pos).normalized(), float(in.roll));
             auto view_arr = cam.getViewUp();
             QVector3D up  = rollRot.rotatedVector(
                 QVector3D(view_arr[0], view_arr[1], view_arr[2]));
             cam.setViewUp({up.x(), up.y(), up.z()});
         }
-    }
-    else if (event->buttons() & Qt::RightButton) {
-        panCamera(delta.x(), delta.y(),
-                  event->modifiers() & Qt::ShiftModifier ? g_shift_delta : 1.);
+        if (!in.pan.isNull()) {
+            auto pos         = cam.getPosition();
+            auto focal       = cam.getFocalPoint();
+            double dist      = std::sqrt(std::pow(focal[0] - pos[0], 2)
+                                         + std::pow(focal[1] - pos[1], 2)
+                                         + std::pow(focal[2] - pos[2], 2));
+            double pan_speed = dist * 0.001;
+            cam.pan(-in.pan.x() * pan_speed, in.pan.y() * pan_speed);
+        }
     }
 }
 
 void F3DWidget::mouseDoubleClickEvent(QMouseEvent *event)
 {
-    if (!m_engine || event->button() != Qt::LeftButton) {
+    if (!isEngineReady() || event->button() != Qt::LeftButton) {
         QOpenGLWidget::mouseDoubleClickEvent(event);
         return;
     }
 
     qprintt << "mouseDoubleClickEvent, resetting camera";
     m_engine->getWindow().getCamera().resetToDefault();
+    update();
 }
 
 void F3DWidget::wheelEvent(QWheelEvent *event)
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return;
     }
 
@@ -462,18 +1075,23 @@ void F3DWidget::wheelEvent(QWheelEvent *event)
         1.0
         + (event->modifiers() & Qt::ShiftModifier ? delta * g_shift_delta
                                                   : delta));
+    beginInteraction();
+    update();
 }
 
 void F3DWidget::keyPressEvent(QKeyEvent *event)
 {
     handleKey(event);
+    emit sigKeyHandled(event->key(), event->modifiers());
 }
 
 void F3DWidget::handleKey(QKeyEvent *event)
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return;
     }
+    // key toggles must see and change the real option values
+    endInteraction();
 
     auto &opt        = m_engine->getOptions();
     const bool shift = event->modifiers() & Qt::ShiftModifier;
@@ -649,12 +1267,17 @@ void F3DWidget::handleKey(QKeyEvent *event)
     catch (...) {
         qprintt << "Error handling key" << event->text();
     }
+    update();
 }
 
 void F3DWidget::moveCamera(CameraPos cp)
 {
+    if (!isEngineReady()) {
+        return;
+    }
     if (cp == CP_Default) {
         m_engine->getWindow().getCamera().resetToDefault();
+        update();
         return;
     }
     auto &cam                 = m_engine->getWindow().getCamera();
@@ -673,7 +1296,7 @@ void F3DWidget::moveCameraTo(const QVector3D &new_pos,
                              const QVector3D &focal,
                              const QVector3D &up)
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return;
     }
     auto animations = this->findChildren<QVariantAnimation *>();
@@ -702,22 +1325,24 @@ void F3DWidget::moveCameraTo(const QVector3D &new_pos,
                 cam.setPosition({current.x(), current.y(), current.z()});
                 cam.setFocalPoint({focal.x(), focal.y(), focal.z()});
                 cam.setViewUp({up.x(), up.y(), up.z()});
+                update();
             });
     connect(anim, &QVariantAnimation::finished, anim, &QObject::deleteLater);
     anim->start();
 }
 
-void F3DWidget::onAnimTick()
+void F3DWidget::advanceAnimation()
 {
-    if (!m_engine || !m_animation.playing) {
+    if (!isAnimationRunning()) {
         return;
     }
+    // Called once per painted frame: the wall-clock delta since the previous
+    // frame is applied in one step, so frames that are never presented cost
+    // no pose evaluation and the clock follows the display refresh rate.
+    // The pose itself is evaluated by loadPose().
     m_animation.pos
         += (m_animation.elapsed.restart() * 1. / 1000. * m_animation.speed);
-    const auto max = m_engine->getScene().animationTimeRange().second;
-    if (max <= 0.0) {
-        return;
-    }
+    const double max = m_animation.duration;
     if (m_animation.loop) {
         m_animation.pos = std::fmod(m_animation.pos, max);
     }
@@ -725,17 +1350,33 @@ void F3DWidget::onAnimTick()
         m_animation.pos = max;
         setAnimationState(false);
     }
-    m_engine->getScene().loadAnimationTime(m_animation.pos);
+    m_animation.seek = true;
     emit sigAnimationProgressChanged(m_animation.pos, max);
 }
 
+void F3DWidget::loadPose()
+{
+    // seeks only move the target, the latest one is evaluated here and
+    // repaints of a paused frame evaluate nothing
+    if (!std::exchange(m_animation.seek, false) || !hasAnimation()) {
+        return;
+    }
+    m_engine->getScene().loadAnimationTime(m_animation.pos);
+}
+
 void F3DWidget::setOption(const QString &key, const QString &v)
 {
+    if (m_loading) {
+        m_pending_options.append({key, v});
+        return;
+    }
     if (!m_engine) {
         return;
     }
+    endInteraction();
     try {
         m_engine->getOptions().setAsString(key.toStdString(), v.toStdString());
+        update();
     }
     catch (...) {
         qprintt << "Error setting option" << key << v;
@@ -744,9 +1385,13 @@ void F3DWidget::setOption(const QString &key, const QString &v)
 
 QVariant F3DWidget::getOption(const QString &key) const
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return {};
     }
+    // passes dropped while interacting still count as on
+    if (m_interactive.disabled.contains(key)) {
+        return true;
+    }
     QVariant ret;
     try {
         ret = QVariant::fromStdVariant(
@@ -764,9 +1409,20 @@ bool F3DWidget::isAxisVisible() const
     return getOption("ui.axis").toBool();
 }
 
+f3d::framestats::Summary F3DWidget::frameStats() const
+{
+    return m_frame_stats.summary();
+}
+
+void F3DWidget::resetFrameStats()
+{
+    m_frame_stats.clear();
+    m_swap_clock.invalidate();
+}
+
 bool F3DWidget::hasAnimation() const
 {
-    return m_engine && m_engine->getScene().animationTimeRange().second > 0.;
+    return isEngineReady() && m_animation.duration > 0.;
 }
 
 void F3DWidget::setAnimationState(bool play)
@@ -777,10 +1433,7 @@ void F3DWidget::setAnimationState(bool play)
     m_animation.playing = play;
     if (play) {
         m_animation.elapsed.restart();
-        m_animation.timer.start();
-    }
-    else {
-        m_animation.timer.stop();
+        update();
     }
     emit sigAnimationStateChanged(m_animation.playing);
 }
@@ -820,27 +1473,27 @@ double F3DWidget::getAnimationPosition() const
 
 double F3DWidget::getAnimationDuration() const
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return 0.0;
     }
-    return m_engine->getScene().animationTimeRange().second;
+    return m_animation.duration;
 }
 
 void F3DWidget::seekAnimation(double time)
 {
-    if (!m_engine || !hasAnimation()) {
+    if (!hasAnimation()) {
         return;
     }
     const double duration = getAnimationDuration();
     m_animation.pos       = qBound(0.0, time, duration);
-    m_engine->getScene().loadAnimationTime(m_animation.pos);
+    m_animation.seek      = true;
     emit sigAnimationProgressChanged(m_animation.pos, duration);
     update();
 }
 
 QStringList F3DWidget::getAnimationNames() const
 {
-    if (!m_engine) {
+    if (!isEngineReady()) {
         return {};
     }
 
@@ -858,28 +1511,37 @@ int F3DWidget::getAnimationSelection() const
 
 bool F3DWidget::setAnimationSelection(int index)
 {
-    if (!m_engine || m_loading || index == m_animation.selection) {
+    if (!isEngineReady() || index == m_animation.selection) {
         return false;
     }
 
+    // libf3d binds animations when the file is added, and the interactor
+    // command cycling them does not exist for an external window, so the
+    // file is added again with only the picked clip bound
+    endInteraction();
     try {
-        m_loading             = true;
-        m_animation.selection = index;
+        auto &scene       = m_engine->getScene();
+        const auto camera = m_engine->getWindow().getCamera().getState();
         m_engine->getOptions().setAsString(
             "scene.animation.indices",
             index < 0 ? "-1" : std::to_string(index));
-        m_engine->getScene().clear();
-        const bool wasPlaying = m_animation.playing;
-        m_animation.playing   = wasPlaying;
-        const bool ok         = addSceneContent();
-        m_loading             = false;
-        if (ok) {
-            emit sigAnimationStateChanged(m_animation.playing);
-            emit sigAnimationProgressChanged(m_animation.pos,
-                                             getAnimationDuration());
-            update();
-        }
-        return ok;
+        m_engine->getOptions().scene.force_reader = m_forced_reader;
+        m_animation.selection                     = index;
+        // dropping the old actors frees GL resources, which needs the context
+        makeCurrent();
+        scene.clear();
+        doneCurrent();
+        {
+            const auto readers = f3d::bootstrap::readersLock();
+            scene.add(toFsPath(m_path));
+        }
+        onSceneAdded();
+        m_engine->getWindow().getCamera().setState(camera);
+        emit sigAnimationStateChanged(m_animation.playing);
+        emit sigAnimationProgressChanged(m_animation.pos,
+                                         getAnimationDuration());
+        update();
+        return true;
     }
     catch (const std::exception &e) {
         qprintt << "Error changing animation selection:" << e.what();
@@ -887,7 +1549,6 @@ bool F3DWidget::setAnimationSelection(int index)
     catch (...) {
         qprintt << "Error changing animation selection";
     }
-    m_loading = false;
     return false;
 }
 
@@ -898,25 +1559,22 @@ bool F3DWidget::isYUp() const
 
 bool F3DWidget::setYUp(bool yUp)
 {
-    if (!m_engine || m_loading || isYUp() == yUp) {
+    if (!isEngineReady() || isYUp() == yUp) {
         return false;
     }
 
+    // The window applies scene.up_direction to the grid, the environment and
+    // the camera reference when it renders; the loaded actors do not depend
+    // on it. The camera of the old axis makes no sense after the change, so
+    // the default one is rebuilt for the new axis.
     try {
-        m_loading = true;
-        m_y_up    = yUp;
         m_engine->getOptions().setAsString("scene.up_direction",
                                            yUp ? "+Y" : "+Z");
-        m_engine->getScene().clear();
-        const bool ok = addSceneContent();
-        m_loading     = false;
-        if (ok) {
-            emit sigAnimationStateChanged(m_animation.playing);
-            emit sigAnimationProgressChanged(m_animation.pos,
-                                             getAnimationDuration());
-            update();
-        }
-        return ok;
+        m_y_up = yUp;
+        endInteraction();
+        setupDefaultCamera();
+        update();
+        return true;
     }
     catch (const std::exception &e) {
         qprintt << "Error changing up direction:" << e.what();
@@ -924,28 +1582,18 @@ bool F3DWidget::setYUp(bool yUp)
     catch (...) {
         qprintt << "Error changing up direction";
     }
-    m_loading = false;
     return false;
 }
 
 void F3DWidget::setUIScale(double scale)
 {
-    if (!m_engine) {
-        return;
-    }
-    try {
-        m_engine->getOptions().setAsString("ui.scale", std::to_string(scale));
-    }
-    catch (...) {
-        qprintt << "Error setting ui.scale" << scale;
-    }
+    setOption("ui.scale", QString::number(scale));
 }
 
-void F3DWidget::applyOptions(const QStringList &args)
+QList<QPair<QString, QString>> F3DWidget::parseOptionArgs(
+    const QStringList &args)
 {
-    if (!m_engine) {
-        return;
-    }
+    QList<QPair<QString, QString>> ret;
     // Seer splits args by space into individual tokens: ["--key", "value"]
     // Also handle single-string form: ["--key value"]
     for (int i = 0; i < args.size(); ++i) {
@@ -972,6 +1620,23 @@ void F3DWidget::applyOptions(const QStringList &args)
         if (key.isEmpty() || value.isEmpty()) {
             continue;
         }
+        ret.append({key, value});
+    }
+    return ret;
+}
+
+void F3DWidget::applyOptions(const QStringList &args)
+{
+    if (!isEngineReady()) {
+        return;
+    }
+    endInteraction();
+    for (const auto &[key, value] : parseOptionArgs(args)) {
+        // "viewer.*" keys configure the plugin itself, not libf3d
+        if (key.startsWith(g_viewer_option_prefix)) {
+            applyViewerOption(key, value);
+            continue;
+        }
         try {
             // normalize "0"/"1" to "false"/"true" for boolean options
             QString v = value;
@@ -987,4 +1652,25 @@ void F3DWidget::applyOptions(const QStringList &args)
             qprintt << "Error applying option" << key << value;
         }
     }
+    update();
+}
+
+void F3DWidget::applyViewerOption(const QString &key, const QString &value)
+{
+    const bool on = value == "1" || value == "true";
+    if (key == g_arg_continuous_render) {
+        m_continuous_render = on;
+    }
+    else if (key == g_arg_interactive_scale) {
+        m_interactive.scale = qBound(0.1, value.toDouble(), 1.0);
+    }
+    else if (key == g_arg_interactive_idle) {
+        m_interactive.idleMs = qMax(0, value.toInt());
+    }
+    else if (key == g_arg_interactive_min) {
+        m_interactive.minFrameMs = qMax(0, value.toInt());
+    }
+    else if (key == g_arg_interactive_pass) {
+        m_interactive.dropPasses = on;
+    }
 }
@@ -1,18 +1,35 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QImage>
 #include <QOpenGLWidget>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
 #include <QVector3D>
 
+#include "F3DFrameStats.h"
+
 namespace f3d {
 class engine;
 }
+namespace f3d::input {
+class Recorder;
+}
+namespace f3d::loadpool {
+struct Ticket;
+}
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
 
 class F3DWidget : public QOpenGLWidget {
     Q_OBJECT
@@ -20,12 +37,53 @@ public:
     explicit F3DWidget(QWidget *parent = nullptr);
     ~F3DWidget() override;
 
+    // How the last background load went, for metrics
+    struct LoadInfo {
+        qint64 parseMs = 0;
+        // scene.add() calls, retries included
+        int attempts = 0;
+        // content detected by the sniffer, "unknown" when left to libf3d
+        QString format;
+        QString reader;
+        bool alias = false;
+        // highest resident set size sampled by the worker, bytes
+        qint64 rssPeak = 0;
+        // parsed ahead of time by prefetch(), before this preview opened
+        bool prefetched = false;
+    };
+
     bool load(const QString &path);
+    // Parses `paths` into engines of their own on a low priority thread. A
+    // widget loading one of them later adopts that engine and skips the
+    // parse, or waits for it when it is still running. Queued parses of
+    // files no longer listed are dropped, recently shown files are skipped.
+    // Parsed scenes are kept while they add up to at most `budgetBytes`,
+    // each charged with its resident set growth but at least twice its file
+    // size, least recently used first out. GUI thread only.
+    static void prefetch(const QStringList &paths,
+                         const QString &readerCache,
+                         qint64 budgetBytes);
+    const LoadInfo &loadInfo() const;
+    // Options and animation state read as empty until the scene is back
+    bool isLoading() const;
+    // Input and resizes from now on are appended to `file` as they happen
+    void startInputRecording(const QString &file);
+    // Shown instead of the "Loading..." text until the scene is ready
+    void setPlaceholder(const QImage &frame);
+    // INI file remembering which fallback reader worked for similar files
+    void setReaderCache(const QString &iniPath);
     void applyOptions(const QStringList &args);
+    // plugin.json args as ordered key/value pairs, without the leading "--"
+    static QList<QPair<QString, QString>> parseOptionArgs(
+        const QStringList &args);
 
     void setOption(const QString &key, const QString &v);
     QVariant getOption(const QString &key) const;
 
+    // CPU time and presentation interval of the recent frames
+    f3d::framestats::Summary frameStats() const;
+    void resetFrameStats();
+
     bool hasAnimation() const;
     void setAnimationState(bool play);
     bool isAnimationRunning() const;
@@ -36,11 +94,17 @@ public:
     bool isAnimationLoopEnabled() const;
     double getAnimationPosition() const;
     double getAnimationDuration() const;
+    // Latest seek wins, the pose is evaluated once by the next frame
     void seekAnimation(double time);
     QStringList getAnimationNames() const;
     int getAnimationSelection() const;
+    // Adds the file again with only that clip bound: libf3d 3.x binds
+    // animations on add and cannot rebind them on a loaded scene. The camera
+    // is kept.
     bool setAnimationSelection(int index);
     bool isYUp() const;
+    // Reorients grid, environment and default camera on the loaded scene,
+    // nothing is read or parsed again
     bool setYUp(bool yUp);
 
     void setUIScale(double scale);
@@ -58,10 +122,15 @@ public:
 
 Q_SIGNALS:
     void sigLoaded();
+    void sigLoadFailed();
     void sigAnimationStateChanged(bool playing);
     void sigAnimationProgressChanged(double current, double duration);
+    // After a key press was handled, it may have toggled options. Sent for
+    // keys typed into the focused widget too, not only forwarded ones.
+    void sigKeyHandled(int key, Qt::KeyboardModifiers modifiers);
 
 protected:
+    bool event(QEvent *event) override;
     void initializeGL() override;
     void resizeGL(int w, int h) override;
     void paintGL() override;
@@ -74,12 +143,80 @@ protected:
     void keyPressEvent(QKeyEvent *event) override;
 
 private:
+    // Shared between the widget and the worker; lets ~F3DWidget abandon a
+    // parse without waiting for scene.add() to return.
+    struct LoadJob {
+        std::atomic_bool cancelled{false};
+        std::mutex mutex;
+        bool done = false;
+        std::shared_ptr<f3d::loadpool::Ticket> ticket;
+        std::unique_ptr<f3d::engine> orphan;
+        // shares the widget's GL objects, so the orphan can be released on
+        // the GUI thread once the widget and its context are gone
+        std::unique_ptr<QOffscreenSurface> surface;
+        std::unique_ptr<QOpenGLContext> context;
+    };
+    struct LoadRequest {
+        std::shared_ptr<LoadJob> job;
+        QString originalPath;
+        QString path;
+        QString aliasPath;
+        std::optional<std::string> forcedReader;
+        QString readerCache;
+    };
+    struct LoadResult {
+        bool ok        = false;
+        bool cancelled = false;
+        QString path;
+        QString aliasPath;
+        std::optional<std::string> forcedReader;
+        LoadInfo info;
+    };
+    // An engine parsed by prefetch(), waiting for a widget to adopt it
+    struct Prefetched {
+        Prefetched() = default;
+        Prefetched(Prefetched &&)            = default;
+        Prefetched &operator=(Prefetched &&) = default;
+        // drops the alias of a scene nobody adopted
+        ~Prefetched();
+
+        std::unique_ptr<f3d::engine> engine;
+        LoadResult result;
+    };
+    struct PrefetchState;
+    static PrefetchState &prefetchState();
+    static void onPrefetched(const QString &path,
+                             const LoadResult &ret,
+                             qint64 bytes);
+    // Takes over a prefetch parse of this file that is already running,
+    // false when there is none and the widget loads it itself
+    bool waitForPrefetch();
+    void adoptPrefetched(Prefetched item);
+    static LoadResult parseScene(f3d::engine *engine, LoadRequest req);
+    static void releaseOrphan(LoadJob &job);
+
+    bool isEngineReady() const;
+    void applyViewerOption(const QString &key, const QString &value);
     void handleKey(QKeyEvent *event);
     void moveCameraTo(const QVector3D &new_pos,
                       const QVector3D &focal,
                       const QVector3D &up);
-    void onAnimTick();
-    bool addSceneContent();
+    void applyPendingInput();
+    void advanceAnimation();
+    // Evaluates the pose at the current position once per pending seek
+    void loadPose();
+    void onSceneAdded();
+    void onLoadFinished();
+    void finishLoad(const LoadResult &ret);
+    void abandonLoad();
+    void paintPlaceholder();
+    // Framebuffer size in device pixels, the unit the GL viewport uses
+    QSize deviceSize() const;
+    // Sizes the f3d window to the full quality framebuffer
+    void syncWindowSize();
+    void renderScene();
+    void beginInteraction();
+    void endInteraction();
     void setupDefaultCamera();
     QVector3D cameraDirection(CameraPos cp) const;
     QVector3D cameraUpVector(CameraPos cp) const;
@@ -87,10 +224,13 @@ private:
 
     struct {
         QElapsedTimer elapsed;
-        QTimer timer;
         double speed = 1.;
+        // cached animationTimeRange() end, refreshed when the scene changes
+        double duration = 0;
         // for loadAnimationTime
-        double pos    = 0;
+        double pos = 0;
+        // pos moved since the scene last evaluated it
+        bool seek     = false;
         bool playing  = true;
         bool loop     = true;
         int selection = -1;
@@ -101,8 +241,45 @@ private:
     QString m_path;
     QString m_load_alias_path;
     std::optional<std::string> m_forced_reader;
-    bool m_loading = false;
-    bool m_y_up    = true;
+    QString m_reader_cache;
+    // option writes issued while the worker owns the engine
+    QList<QPair<QString, QString>> m_pending_options;
+    QImage m_placeholder;
+    QFutureWatcher<LoadResult> m_load_watcher;
+    std::shared_ptr<LoadJob> m_load_job;
+    LoadInfo m_load_info;
+    std::unique_ptr<f3d::input::Recorder> m_input_recorder;
+    bool m_loading           = false;
+    bool m_continuous_render = false;
+    f3d::framestats::Recorder m_frame_stats;
+    QElapsedTimer m_swap_clock;
+    // paintGL() time of the frame about to be swapped, < 0 for placeholders
+    double m_paint_ms = -1;
+    // Reduced quality while the camera is being dragged or zoomed
+    struct {
+        QTimer idle;
+        bool active = false;
+        // viewer.interactive.* settings
+        double scale     = 0.5;
+        int idleMs       = 200;
+        int minFrameMs   = 20;
+        bool dropPasses  = true;
+        qint64 lastFrame = 0;
+        // effects switched off for the interaction, restored when idle
+        QStringList disabled;
+        std::unique_ptr<QOpenGLFramebufferObject> fbo;
+    } m_interactive;
+    bool m_y_up = true;
 
     QPointF m_pos;
+    // camera steps gathered from mouse moves since the last painted frame,
+    // one per event and replayed in order, as azimuth, elevation and roll
+    // do not commute
+    struct InputStep {
+        double azimuth   = 0;
+        double elevation = 0;
+        double roll      = 0;
+        QPointF pan;
+    };
+    std::vector<InputStep> m_pending_input;
 };
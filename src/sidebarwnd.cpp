@@ -25,6 +25,8 @@ SidebarWnd::SidebarWnd(QWidget *parent)
     ui->slider_ani_progress->setEnabled(false);
     ui->label_ani_progress_val->setText("0.0 / 0.0");
     ui->label_render_opacity_val->setText("100%");
+    ui->label_perf_stats->setTextFormat(Qt::RichText);
+    updatePerformance({});
     ui->widget_keys_content->setVisible(false);
     ui->toolButton_keys_toggle->setAutoRaise(true);
     ui->toolButton_keys_toggle->setStyleSheet(
@@ -128,6 +130,8 @@ SidebarWnd::SidebarWnd(QWidget *parent)
             &SidebarWnd::sigShowBackgroundBlur);
     connect(ui->pushButton_render_reset, &QPushButton::clicked, this,
             &SidebarWnd::sigResetViewOptions);
+    connect(ui->pushButton_perf_copy, &QPushButton::clicked, this,
+            &SidebarWnd::sigCopyPerformance);
 
     connect(
         ui->slider_render_opacity, &QSlider::valueChanged, this,
@@ -149,6 +153,13 @@ SidebarWnd::SidebarWnd(QWidget *parent)
             &SidebarWnd::sigAnimationLoopChanged);
     connect(ui->slider_ani_progress, &QSlider::sliderPressed, this,
             [this]() { ui->slider_ani_progress->setEnabled(true); });
+    // live scrubbing, F3DWidget only evaluates the latest position per frame
+    connect(ui->slider_ani_progress, &QSlider::sliderMoved, this,
+            [this](int value) {
+                if (!m_syncing) {
+                    emit sigSeekAnimation(value / 1000.0);
+                }
+            });
     connect(ui->slider_ani_progress, &QSlider::sliderReleased, this, [this]() {
         if (m_syncing) {
             return;
@@ -301,6 +312,29 @@ void SidebarWnd::updateAnimationProgress(double current, double duration)
         QString("%1 / %2").arg(current, 0, 'f', 1).arg(duration, 0, 'f', 1));
 }
 
+void SidebarWnd::updatePerformance(const f3d::framestats::Summary &stats)
+{
+    auto row = [](const QString &name, const f3d::framestats::Percentiles &p) {
+        return QString("<tr><td>%1</td><td align='right'>%2</td>"
+                       "<td align='right'>%3</td><td align='right'>%4</td>"
+                       "</tr>")
+            .arg(name)
+            .arg(p.p50, 0, 'f', 1)
+            .arg(p.p95, 0, 'f', 1)
+            .arg(p.p99, 0, 'f', 1);
+    };
+    QString html = "<table cellspacing='0' cellpadding='1' width='100%'>"
+                   "<tr><td>ms</td><td align='right'>p50</td>"
+                   "<td align='right'>p95</td><td align='right'>p99</td></tr>";
+    html.append(row("CPU", stats.cpu));
+    html.append(row("Frame", stats.interval));
+    html.append("</table>");
+    html.append(QString("<div>%1 frames, %2 hitches</div>")
+                    .arg(stats.frames)
+                    .arg(stats.hitches));
+    ui->label_perf_stats->setText(html);
+}
+
 void SidebarWnd::on_pushButton_ani_play_clicked()
 {
     m_ani_run = !m_ani_run;
@@ -3,6 +3,8 @@
 #include <QStringList>
 #include <QWidget>
 
+#include "f3dwidget/F3DFrameStats.h"
+
 namespace Ui {
 class SidebarWnd;
 }
@@ -75,10 +77,12 @@ public:
     Q_SIGNAL void sigOpacityChanged(double opacity);
     Q_SIGNAL void sigAnimationSpeedChanged(double speed);
     Q_SIGNAL void sigResetViewOptions();
+    Q_SIGNAL void sigCopyPerformance();
 
     void syncControls(const State &state);
     void setAnimationList(const QStringList &names, int currentIndex);
     void updateAnimationProgress(double current, double duration);
+    void updatePerformance(const f3d::framestats::Summary &stats);
 
 private:
     Q_SLOT void on_pushButton_ani_play_clicked();